@@ -6,6 +6,7 @@ TEST 'A=15 M=A' {
 	// Write instructions
 	SET com.clock         = 1;
 	SET com.load          = 1;
+	SET com.reset         = 1; // Keep the PC on 0 while writing.
 
 	// @15
 	SET com.in            = 15;
@@ -51,6 +52,7 @@ TEST 'A=1337 D=A A=15 M=D' {
 	// Write instructions
 	SET com.clock         = 1;
 	SET com.load          = 1;
+	SET com.reset         = 1; // Keep the PC on 0 while writing.
 
 	// @1337
 	SET com.in            = 1337;
@@ -126,6 +128,7 @@ TEST 'jump' {
 	// Write instructions
 	SET com.clock         = 1;
 	SET com.load          = 1;
+	SET com.reset         = 1; // Keep the PC on 0 while writing.
 
 	// @1337
 	SET com.in            = 1337;
@@ -179,6 +182,7 @@ TEST 'jump cond' {
 	// Write instructions
 	SET com.clock         = 1;
 	SET com.load          = 1;
+	SET com.reset         = 1; // Keep the PC on 0 while writing.
 
 	// D=1
 	SET com.in            = 61392;
@@ -0,0 +1,21 @@
+LOAD oscillator;
+
+// A nand feeding back into itself, it never settles while enabled.
+
+TEST 'oscillator disabled' {
+	VAR o: oscillator;
+	EVAL;
+	REQUIRE o.out IS 1;
+}
+
+TEST 'oscillator enabled' {
+	VAR o: oscillator;
+	SET o.enable = 1;
+	EVAL;
+	EVAL;
+
+	// Disabling it settles it again.
+	SET o.enable = 0;
+	EVAL;
+	REQUIRE o.out IS 1;
+}
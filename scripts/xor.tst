@@ -35,3 +35,17 @@ TEST 'xor 1 1' {
 	    AND (a.b IS 1)
 		AND (a.out IS 0);
 }
+
+TEST 'xor redeclared' {
+	VAR a: xor;
+	SET a.a = 1;
+	EVAL;
+	REQUIRE a.out IS 1;
+
+	// Replaces the variable while its REQUIRE may still be pending.
+	VAR a: xor;
+	SET a.b = 1;
+	SET a.a = 1;
+	EVAL;
+	REQUIRE a.out IS 0;
+}
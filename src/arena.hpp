@@ -0,0 +1,220 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <deque>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * A monotonic buffer for the gates, pins and wires created while instantiating
+ * chips. Nothing allocated from it is freed on its own, the whole buffer is
+ * released at once when the arena is destroyed, so an arena has to outlive
+ * everything that was built in it.
+ *
+ * Allocations only go to an arena while one of its Scopes is active on the
+ * current thread, everything else keeps using the heap:
+ *
+ *   GateArena arena{};
+ *   {
+ *     GateArena::Scope scope{ arena };
+ *     auto copy = component.duplicate(board);  // Built inside of 'arena'.
+ *   }
+ */
+class GateArena
+{
+public:
+  GateArena() = default;
+  GateArena(const GateArena&) = delete;
+  GateArena& operator=(const GateArena&) = delete;
+
+  /**
+   * Routes the allocations of the current thread to an arena until destroyed.
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(GateArena& arena)
+      : previous{ active }
+    {
+      active = &arena;
+    }
+
+    /**
+     * Goes back to the heap, for whatever has to outlive the active arena.
+     */
+    explicit Scope(std::nullptr_t)
+      : previous{ active }
+    {
+      active = nullptr;
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    ~Scope()
+    {
+      active = previous;
+    }
+
+  private:
+    GateArena* previous;
+  };
+
+  /**
+   * The memory resource new objects should come from, the heap outside of a Scope.
+   */
+  static auto current() -> std::pmr::memory_resource*
+  {
+    return active == nullptr ? std::pmr::new_delete_resource() : &active->buffer;
+  }
+
+  /**
+   * Allocate an object, from the active arena if there is one. A header in
+   * front of the object remembers where it came from, so that it can be
+   * released correctly no matter which scope is active at that point.
+   */
+  static auto allocate_object(std::size_t size) -> void*
+  {
+    auto* block = (active == nullptr)
+      ? static_cast<std::byte*>(::operator new(HEADER + size))
+      : static_cast<std::byte*>(active->buffer.allocate(HEADER + size, alignof(std::max_align_t)));
+
+    *reinterpret_cast<GateArena**>(block) = active;
+    return block + HEADER;
+  }
+
+  static auto deallocate_object(void* object) -> void
+  {
+    if (object == nullptr) return;
+
+    auto* block = static_cast<std::byte*>(object) - HEADER;
+
+    // Arena memory is only given back when the arena goes away.
+    if (*reinterpret_cast<GateArena**>(block) == nullptr)
+    {
+      ::operator delete(block);
+    }
+  }
+
+  /**
+   * Bytes taken from the heap by the arena so far.
+   */
+  auto reserved() const -> std::size_t
+  {
+    return tracker.bytes;
+  }
+
+private:
+  static constexpr std::size_t HEADER{ alignof(std::max_align_t) };
+
+  /**
+   * Counts what the monotonic buffer requests from the heap.
+   */
+  struct Tracker : std::pmr::memory_resource
+  {
+    std::size_t bytes{};
+
+    auto do_allocate(std::size_t size, std::size_t alignment) -> void* override
+    {
+      bytes += size;
+      return std::pmr::new_delete_resource()->allocate(size, alignment);
+    }
+
+    auto do_deallocate(void* pointer, std::size_t size, std::size_t alignment) -> void override
+    {
+      std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+    }
+
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override
+    {
+      return this == &other;
+    }
+  };
+
+  static inline thread_local GateArena* active{ nullptr };
+
+  Tracker                             tracker{};
+  std::pmr::monotonic_buffer_resource buffer{ &tracker };
+};
+
+/**
+ * Allocator of the containers inside of a gate. It picks its memory resource
+ * when the container is created (GateArena::current()) and keeps it, a
+ * container built inside of an arena stays in that arena as it grows.
+ */
+template <typename T>
+struct ArenaAllocator
+{
+  using value_type = T;
+
+  ArenaAllocator() noexcept
+    : resource{ GateArena::current() }
+  {
+  }
+
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+    : resource{ other.resource }
+  {
+  }
+
+  auto allocate(std::size_t count) -> T*
+  {
+    return static_cast<T*>(resource->allocate(count * sizeof(T), alignof(T)));
+  }
+
+  auto deallocate(T* pointer, std::size_t count) -> void
+  {
+    resource->deallocate(pointer, count * sizeof(T), alignof(T));
+  }
+
+  /**
+   * Copies belong wherever they are made, not to the arena of the original.
+   */
+  auto select_on_container_copy_construction() const -> ArenaAllocator
+  {
+    return {};
+  }
+
+  template <typename U>
+  auto operator==(const ArenaAllocator<U>& other) const noexcept -> bool
+  {
+    return resource == other.resource;
+  }
+
+  std::pmr::memory_resource* resource;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template <typename T>
+using ArenaDeque = std::deque<T, ArenaAllocator<T>>;
+
+#endif /* ARENA_H */
@@ -26,15 +26,25 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 
 #include "lang/assem/token_assem.hpp"
 #include "lang/core/trie.hpp"
 #include "lang/hdl/parser.hpp"
 #include "gate.hpp"
+#include "netlist.hpp"
 #include "utils.hpp"
 #include "builtin/builtin.hpp"
+#include "content_hash.hpp"
+#include "gate_binary.hpp"
+#include "table_cache.hpp"
 
 // We have a single static instance of the board (this will have the lifetime of the program)
 class Board
@@ -48,10 +58,11 @@ public:
 
     add_built_in(std::move(nand));
     add_built_in(std::move(dff));
-    add_built_in(std::make_unique<PC>());
-    add_built_in(std::make_unique<Ram16k>());
-    add_built_in(std::make_unique<Mux16>());
-    add_built_in(std::make_unique<Rom32k>());
+    const auto& builtins = BuiltinRegistry::instance();
+    add_built_in(builtins.create(PC::NAME));
+    add_built_in(builtins.create(Ram16k::NAME));
+    add_built_in(builtins.create(Mux16::NAME));
+    add_built_in(builtins.create(Rom32k::NAME));
 
     if (is_singleton)
     {
@@ -61,6 +72,8 @@ public:
 
   void add_built_in(std::unique_ptr<Gate> builtin_gate)
   {
+    if (builtin_gate == nullptr) return;
+
     auto gate_ptr = builtin_gate.get();
 
     // Kind of misleading, technically, this should be 'serializable'
@@ -90,6 +103,12 @@ public:
   {
     auto gate = std::make_unique<Gate>();
     gate->set_name(name);
+
+    if (accelerated_builtins)
+    {
+      accelerate(*gate, true);
+    }
+
     components[make_lower(name)] = std::move(gate);
   }
 
@@ -110,17 +129,53 @@ public:
     current = f ? std::pair(case_insensitive_name, components[entry].get()) : std::pair{"", nullptr};
   }
 
+  /**
+   * True if the chip is loaded.
+   */
   bool found(std::string_view name)
   {
     std::string entry{ name };
     return components.find(entry) != components.end();
   }
 
+  /**
+   * True if the chip is loaded or registered.
+   */
+  bool known(std::string_view name)
+  {
+    return found(name) || registered.contains(std::string(name));
+  }
+
+  /**
+   * Make a chip known by the .gate file defining it without loading it, it is
+   * loaded the first time it is asked for (by get_component, as a subgate or
+   * by a test). Loaded chips are not registered again.
+   */
+  void register_file(std::string_view name, const std::string& file_path)
+  {
+    const auto entry = make_lower(name);
+    if (found(entry))
+    {
+      return;
+    }
+
+    registered[entry] = file_path;
+    search_trie.insert(entry);
+  }
+
   auto context()
   {
     return current;
   }
 
+  /**
+   * The trie of component names used by search.
+   */
+  auto get_search_index() const -> const Trie&
+  {
+    return search_trie;
+  }
+
   std::vector<Gate*> search(const std::string& name) 
   {
       std::vector<Gate*> res;
@@ -150,9 +205,136 @@ public:
         return p;
     }
 
+    // Registered chips are loaded on first use, possibly while another file is being loaded.
+    if (auto file = registered.find(std::string(name)); file != registered.end())
+    {
+      // Unregistered while loading, a chip which (indirectly) uses itself must not load again.
+      const auto path = file->second;
+      registered.erase(file);
+
+      const auto context = current;
+
+      // Prototypes stay on the board, they must not end up in the arena of whoever asked.
+      GateArena::Scope heap{ nullptr };
+      const auto loaded = load_file(path);
+      current = context;
+
+      if (loaded)
+      {
+        return get_component(name);
+      }
+
+      // Keep it registered, it loads once the file is fixed.
+      registered.emplace(std::string(name), path);
+    }
+
     return nullptr;
   }
 
+  void set_simulation_mode(SimulationMode mode)
+  {
+    simulation = mode;
+  }
+
+  auto simulation_mode() const -> SimulationMode
+  {
+    return simulation;
+  }
+
+  /**
+   * While enabled, chips with a native accelerator (add_16, alu, ...) are
+   * instantiated as that builtin instead of their HDL definition. Only new
+   * instances are affected, chips which were already built keep their gates.
+   * The reference engine never runs accelerators, see reference_copy.
+   */
+  void set_accelerated_builtins(bool on)
+  {
+    accelerated_builtins = on;
+
+    for (auto& [name, component] : components)
+    {
+      accelerate(*component, on);
+    }
+  }
+
+  auto accelerates_builtins() const -> bool
+  {
+    return accelerated_builtins;
+  }
+
+  /**
+   * Copy a chip as written in HDL, whether builtins are accelerated or not.
+   * The reference engine runs on such copies: its propagation reaches the
+   * clocked parts of a chip in another order once some of its parts are
+   * native, and what those latch depends on that order.
+   */
+  auto reference_copy(Gate& chip) -> std::unique_ptr<Gate>
+  {
+    if (!accelerated_builtins)
+    {
+      return chip.duplicate(this);
+    }
+
+    set_accelerated_builtins(false);
+    auto copy = chip.duplicate(this);
+    set_accelerated_builtins(true);
+    return copy;
+  }
+
+  /**
+   * Use the same simulation settings as another board.
+   */
+  void inherit_settings(const Board& other)
+  {
+    set_simulation_mode(other.simulation_mode());
+    set_report_activity(other.reports_activity());
+    set_accelerated_builtins(other.accelerates_builtins());
+  }
+
+  void set_report_activity(bool report)
+  {
+    report_activity = report;
+  }
+
+  auto reports_activity() const -> bool
+  {
+    return report_activity;
+  }
+
+  /**
+   * Hash of everything which determines the behaviour of a gate: its pins,
+   * its wiring and (recursively) the content of every subgate.
+   */
+  auto content_hash(const Gate& gate) -> std::uint64_t
+  {
+    std::unordered_map<std::string, std::uint64_t> known{};
+    return content_hash(gate, known);
+  }
+
+  /**
+   * Serialize the gate, reusing the table cached on disk if the gate did not change.
+   */
+  auto precompute(Gate& gate) -> bool
+  {
+    const auto hash = content_hash(gate);
+
+    if (TableCache::load(gate, hash))
+    {
+      return true;
+    }
+
+    if (!gate.serialize())
+    {
+      return false;
+    }
+
+    TableCache::save(gate, hash);
+    return true;
+  }
+
+  /**
+   * Names of the loaded and registered chips, sorted.
+   */
   std::vector<std::string_view> get_names()
   {
     std::vector<std::string_view> res;
@@ -162,11 +344,22 @@ public:
       res.push_back(k);
     }
 
+    for (const auto& [k, _] : registered)
+    {
+      if (!found(k)) res.push_back(k);
+    }
+
+    std::sort(res.begin(), res.end());
     return res;
   }
 
   bool load_file(const std::string& file_path)
   {
+    if (const auto binary = GateBinary::open(file_path))
+    {
+      return load_binary(*binary);
+    }
+
     AssemTokenTypeScanner scanner{};
 
   	if (!scanner.read_source(std::string(file_path)))
@@ -176,6 +369,19 @@ public:
 
   	auto board = this;
 
+    // What the file declares, saved as its binary form once it loaded. Only files declaring
+    // a single gate in the order the binary form replays them (see load_binary) have one.
+    GateDefinition definition{};
+    std::size_t    created{};
+    bool           binary_form{ true };
+    int            section{};
+
+    const auto enter = [&](int next)
+    {
+      binary_form &= next >= section;
+      section = next;
+    };
+
   	while (!scanner.is_at_end())
   	{
   		const auto token = scanner.scan_token();		
@@ -192,7 +398,7 @@ public:
         break; case AssemTokenType::Need: 
   			{
   				const auto next = scanner.scan_token();
-  				const auto chip_name = next.lexeme;
+  				const std::string chip_name { next.lexeme };
 
   				if (next.type != AssemTokenType::Identifier)
   				{
@@ -200,54 +406,13 @@ public:
   					return false;
   				}
 				
-  				if (!board->found(chip_name) && !load_file(GATE_RECIPE_DIRECTORY + chip_name + GATE_EXTENSION))
+  				if (!need(chip_name))
   				{
-          	auto hdl_parser = hdl::HDLParser(hdl_file(chip_name));
-            
-          	if (hdl_parser.error_occured())
-          	{
-          		error("Failed to open file '" + chip_name + "'.");
-          		return false;
-          	}
-
-            const bool success = hdl_parser.parse();
-
-          	if (!success)
-          	{
-    					log("Error: Needed component with given name `", chip_name, "` not found!");
-    					exit(1);
-          	}
-
-          	const auto result = hdl_parser.result();
-
-          	// Gate file.
-            std::ofstream gate_file { 
-              DEFAULT_GATE_DIRECTORY + 
-              std::string("/") +  
-              DEFAULT_RECIPE_SAVE_DIRECTORY + 
-              std::string("/") +  
-              chip_name + 
-              GATE_EXTENSION 
-            };
-          	gate_file << result.compile();
-          	gate_file.close();
-
-          	// Meta file.
-            std::ofstream meta_file { 
-              SCRIPTS_DIR + 
-              std::string("/") +  
-              chip_name + 
-              META_EXTENSION 
-            };
-          	meta_file << result.meta();
-          	meta_file.close();
-
-            if (!load_file(GATE_RECIPE_DIRECTORY + chip_name + GATE_EXTENSION))
-            {
-    					log("Error: Failed to load component with given name `", chip_name, "`.");
-    					exit(1);
-            }
+            return false;
   				}
+
+          definition.needs.push_back(chip_name);
+          enter(0);
   			}
         break; case AssemTokenType::Precompute:
         {
@@ -259,12 +424,18 @@ public:
   					return false;
   				}
 
-          current->serialize();
+          if (!precompute(*current))
+          {
+            error("Component `" + current->name + "` has too many inputs to be precomputed, skipping.");
+          }
+
+          definition.precompute = true;
+          enter(5);
         }
         break; case AssemTokenType::Create: 
   			{
   				const auto next = scanner.scan_token();
-  				const auto name = next.lexeme;
+  				const std::string name { next.lexeme };
 
   				if (next.type != AssemTokenType::Identifier && !next.type.is_keyword())
   				{
@@ -280,6 +451,10 @@ public:
   					log("Create: Error: Failed to create context.");
   				}
 
+          definition.name = name;
+          created++;
+          enter(1);
+
   			}
         break; case AssemTokenType::In: 
   			{
@@ -299,7 +474,10 @@ public:
   					return false;
   				}
 
-  				current->add_input_pin(std::stoi(next.lexeme));
+  				current->add_input_pin(std::stoi(std::string(next.lexeme)));
+
+          definition.inputs += std::stoi(std::string(next.lexeme));
+          enter(2);
   			}
         break; case AssemTokenType::Out:
   			{
@@ -319,7 +497,10 @@ public:
   					return false;
   				}
 
-  				current->add_output_pin(std::stoi(next.lexeme));
+  				current->add_output_pin(std::stoi(std::string(next.lexeme)));
+
+          definition.outputs += std::stoi(std::string(next.lexeme));
+          enter(2);
   			}
         break; case AssemTokenType::Add: 
   			{
@@ -332,11 +513,13 @@ public:
   				}
 
   				const auto next = scanner.scan_token();
-  				const auto chip_name = next.lexeme;
+  				const std::string chip_name { next.lexeme };
 
   				if (auto component = board->get_component(chip_name); component != nullptr)
   				{
   					current.second->add_subgate(component, this);
+  					definition.subgates.push_back(chip_name);
+  					enter(3);
   				}
   				else
   				{
@@ -364,29 +547,252 @@ public:
   					return false;
   				}
 
-  				if (!current->wire_pins(std::stoi(pin1.lexeme), std::stoi(pin2.lexeme)))
+  				if (!current->wire_pins(std::stoi(std::string(pin1.lexeme)), std::stoi(std::string(pin2.lexeme))))
   				{
-  					error("Failed to wire pin " + pin1.lexeme + " and pin " + pin2.lexeme);
+  					error("Failed to wire pin " + std::string(pin1.lexeme) + " and pin " + std::string(pin2.lexeme));
   					return false;
   				}
+
+          definition.wires.push_back({ static_cast<std::size_t>(std::stoi(std::string(pin1.lexeme))), static_cast<std::size_t>(std::stoi(std::string(pin2.lexeme))) });
+          enter(4);
   			}
         break; case AssemTokenType::Save: 
   			{
   				// Simply get out of context.
   				board->reset_context();
+  				enter(6);
   			}
       }
   	}
 
+    if (binary_form && created == 1 && section == 6)
+    {
+      GateBinary::save(file_path, definition);
+    }
+
   	return true;
   }
 
+  /**
+   * Load a gate from the binary form of its .gate file, the same way load_file would.
+   */
+  bool load_binary(const GateBinary& binary)
+  {
+    for (std::size_t i = 0; i < binary.need_count(); i++)
+    {
+      if (!need(std::string(binary.need(i))))
+      {
+        return false;
+      }
+    }
+
+    create_new(binary.name());
+    set_context(binary.name());
+
+    auto current = context().second;
+    if (current == nullptr)
+    {
+      log("Create: Error: Failed to create context.");
+      return false;
+    }
+
+    current->add_input_pin(static_cast<int>(binary.input_count()));
+    current->add_output_pin(static_cast<int>(binary.output_count()));
+
+    for (std::size_t i = 0; i < binary.subgate_count(); i++)
+    {
+      const auto chip_name = binary.subgate(i);
+      if (get_component(chip_name) == nullptr)
+      {
+        error("Component with given name `" + std::string(chip_name) + "` not found!");
+        return false;
+      }
+
+      current->add_subgate(chip_name, this);
+    }
+
+    const auto wires = binary.wires();
+    for (std::size_t i = 0; i < wires.size(); i += 2)
+    {
+      if (!current->wire_pins(wires[i], wires[i + 1]))
+      {
+        error("Failed to wire pin " + std::to_string(wires[i]) + " and pin " + std::to_string(wires[i + 1]));
+        return false;
+      }
+    }
+
+    if (binary.precompute() && !precompute(*current))
+    {
+      error("Component `" + current->name + "` has too many inputs to be precomputed, skipping.");
+    }
+
+    reset_context();
+    return true;
+  }
+
+  /**
+   * Compile the HDL of a chip into its .gate and .meta files, without loading it.
+   * Errors are reported to 'errors'. Touches no board, so chips may be compiled in parallel.
+   */
+  static bool compile_recipe(const std::string& chip_name, std::ostream& errors)
+  {
+    auto hdl_parser = hdl::HDLParser(hdl_file(chip_name), errors);
+
+    if (hdl_parser.error_occured())
+    {
+      errors << "Failed to open file '" << chip_name << "'.\n";
+      return false;
+    }
+
+    if (!hdl_parser.parse())
+    {
+      return false;
+    }
+
+    const auto& result = hdl_parser.result();
+
+    // Meta file.
+    write_file(SCRIPTS_DIR + std::string("/") + chip_name + META_EXTENSION, result.meta());
+
+    // Gate file.
+    save_recipe(chip_name, result);
+
+    return true;
+  }
+
+  /**
+   * Write the .gate file of a compiled chip, and its binary form.
+   */
+  static void save_recipe(const std::string& chip_name, const hdl::RecipeBuilder& recipe)
+  {
+    const auto path = GATE_RECIPE_DIRECTORY + chip_name + GATE_EXTENSION;
+    if (write_file(path, recipe.compile()) || !GateBinary::open(path))
+    {
+      GateBinary::save(path, recipe.definition());
+    }
+  }
+
+private:
+  /**
+   * Make sure a chip needed by the file being loaded is on the board,
+   * loading its .gate file or compiling its HDL if it is missing.
+   */
+  bool need(const std::string& chip_name)
+  {
+    if (found(chip_name) || load_file(GATE_RECIPE_DIRECTORY + chip_name + GATE_EXTENSION))
+    {
+      return true;
+    }
+
+    // Boards loading in parallel may all miss the same chip, only one of them compiles it.
+    std::scoped_lock lock{ compile_mutex };
+
+    return load_file(GATE_RECIPE_DIRECTORY + chip_name + GATE_EXTENSION) || compile_hdl(chip_name);
+  }
+
+  /**
+   * Compile the HDL of a chip into its .gate and .meta files and load it.
+   */
+  bool compile_hdl(const std::string& chip_name)
+  {
+    if (!compile_recipe(chip_name, std::cout))
+    {
+      log("Error: Needed component with given name `", chip_name, "` could not be compiled.");
+      return false;
+    }
+
+    if (!load_file(GATE_RECIPE_DIRECTORY + chip_name + GATE_EXTENSION))
+    {
+      log("Error: Failed to load component with given name `", chip_name, "`.");
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Write through a temporary file, other boards never read a half written file.
+   * A file which already has the content is left untouched, returns whether it was written.
+   */
+  static bool write_file(const std::string& path, const std::string& content)
+  {
+    {
+      std::ifstream existing{ path, std::ios::binary };
+      if (existing && std::string(std::istreambuf_iterator<char>(existing), std::istreambuf_iterator<char>()) == content)
+      {
+        return false;
+      }
+    }
+
+    const auto temporary = temporary_file(path);
+    {
+      std::ofstream file{ temporary };
+      file << content;
+    }
+
+    std::error_code ec{};
+    std::filesystem::rename(temporary, path, ec);
+    return true;
+  }
+
+  static void accelerate(Gate& gate, bool on)
+  {
+    if (gate.type != GateType::CUSTOM) return;
+
+    const auto& builtins = BuiltinRegistry::instance();
+    if (const auto accelerator = builtins.find_accelerator(gate.name); accelerator != NO_BUILTIN)
+    {
+      gate.opcode = on ? accelerator : builtins.find(gate.name);
+    }
+  }
+
+  auto content_hash(const Gate& gate, std::unordered_map<std::string, std::uint64_t>& known) -> std::uint64_t
+  {
+    ContentHash hash{};
+    hash.add(static_cast<std::uint64_t>(gate.type))
+        .add(gate.input_pins.size())
+        .add(gate.output_pins.size());
+
+    // Builtins are only identified by their name.
+    if (gate.type != GateType::CUSTOM)
+    {
+      return hash.add(gate.name).value();
+    }
+
+    for (const auto& subgate : gate.subgates)
+    {
+      hash.add(subgate->name);
+
+      if (!known.contains(subgate->name))
+      {
+        // Subgates of a serialized component are bare copies, the component has the full definition.
+        const auto* component = get_component(subgate->name);
+        const auto& definition = (component != nullptr && component != &gate) ? *component : *subgate;
+        known[subgate->name] = content_hash(definition, known);
+      }
+
+      hash.add(known[subgate->name]);
+    }
+
+    for (const auto& [src, dest] : gate.wire_construction_recipe)
+    {
+      hash.add(src).add(dest);
+    }
+
+    return hash.value();
+  }
+
 private:
   Trie                                         search_trie;
   static Board*                                singleton;
   std::pair<std::string, Gate*>                current;
   std::map<std::string, std::unique_ptr<Gate>> components;
+  std::map<std::string, std::string>           registered;
   bool                                         is_singleton = false;
+  SimulationMode                               simulation = SimulationMode::Reference;
+  bool                                         report_activity = false;
+  bool                                         accelerated_builtins = false;
+  static inline std::recursive_mutex           compile_mutex{};
 };
 
 inline Board* Board::singleton = nullptr;
@@ -0,0 +1,180 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include "build_manifest.hpp"
+#include "common.hpp"
+#include "content_hash.hpp"
+
+namespace
+{
+
+auto gate_file(const std::string& chip) -> std::string
+{
+  return GATE_RECIPE_DIRECTORY + chip + GATE_EXTENSION;
+}
+
+auto meta_file(const std::string& chip) -> std::string
+{
+  return SCRIPTS_DIR + SEPERATOR + chip + META_EXTENSION;
+}
+
+} /* namespace */
+
+auto BuildManifest::path() -> std::string
+{
+  return DEFAULT_GATE_DIRECTORY + SEPERATOR + MANIFEST_FILE;
+}
+
+auto BuildManifest::hash_file(const std::string& path) -> std::uint64_t
+{
+  std::ifstream file{ path, std::ios::binary };
+  if (!file)
+  {
+    return 0;
+  }
+
+  const std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+  return ContentHash().add(content).value();
+}
+
+/**
+ * One line per chip followed by one line per used chip:
+ *
+ *   chip <name> <source hash> <gate hash> <meta hash>
+ *   uses <name> <meta hash>
+ */
+auto BuildManifest::load() -> BuildManifest
+{
+  BuildManifest manifest{};
+
+  std::ifstream file{ path() };
+  ManifestEntry* entry{ nullptr };
+
+  for (std::string line{}; std::getline(file, line);)
+  {
+    std::istringstream fields{ line };
+    std::string kind{}, name{};
+    fields >> kind >> name;
+
+    if (kind == "chip")
+    {
+      entry = &manifest.entries[name];
+      fields >> std::hex >> entry->source >> entry->gate >> entry->meta;
+    }
+    else if (kind == "uses" && entry != nullptr)
+    {
+      fields >> std::hex >> entry->uses[name];
+    }
+  }
+
+  return manifest;
+}
+
+auto BuildManifest::save() const -> bool
+{
+  const auto target = path();
+  const auto temporary = temporary_file(target);
+
+  {
+    std::ofstream file{ temporary, std::ios::trunc };
+    if (!file)
+    {
+      return false;
+    }
+
+    for (const auto& [chip, entry] : entries)
+    {
+      file << "chip " << chip << ' ' << ContentHash::to_hex(entry.source) << ' ' << ContentHash::to_hex(entry.gate)
+           << ' ' << ContentHash::to_hex(entry.meta) << '\n';
+
+      for (const auto& [used, meta] : entry.uses)
+      {
+        file << "uses " << used << ' ' << ContentHash::to_hex(meta) << '\n';
+      }
+    }
+
+    if (!file)
+    {
+      return false;
+    }
+  }
+
+  std::error_code ec{};
+  std::filesystem::rename(temporary, target, ec);
+  return !ec;
+}
+
+auto BuildManifest::is_up_to_date(const std::string& chip, const std::vector<std::string>& uses) const -> bool
+{
+  const auto found = entries.find(chip);
+  if (found == entries.end())
+  {
+    return false;
+  }
+
+  const auto& entry = found->second;
+  if (entry.uses.size() != uses.size())
+  {
+    return false;
+  }
+
+  for (const auto& used : uses)
+  {
+    const auto recorded = entry.uses.find(used);
+    if (recorded == entry.uses.end() || recorded->second != hash_file(meta_file(used)))
+    {
+      return false;
+    }
+  }
+
+  return entry.source == hash_file(hdl_file(chip))
+      && entry.gate == hash_file(gate_file(chip))
+      && entry.meta == hash_file(meta_file(chip));
+}
+
+auto BuildManifest::is_source_changed(const std::string& chip) const -> bool
+{
+  const auto found = entries.find(chip);
+  return found != entries.end() && found->second.source != hash_file(hdl_file(chip));
+}
+
+void BuildManifest::record(const std::string& chip, const std::vector<std::string>& uses)
+{
+  auto& entry = entries[chip];
+  entry.source = hash_file(hdl_file(chip));
+  entry.gate = hash_file(gate_file(chip));
+  entry.meta = hash_file(meta_file(chip));
+
+  entry.uses.clear();
+  for (const auto& used : uses)
+  {
+    entry.uses[used] = hash_file(meta_file(used));
+  }
+}
@@ -0,0 +1,91 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef BUILD_MANIFEST_H
+#define BUILD_MANIFEST_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * What a chip was compiled from and into: the content hashes of its HDL
+ * file, of its .gate and .meta outputs, and of the .meta file of every chip
+ * it uses (0 for chips without one, like builtins).
+ */
+struct ManifestEntry
+{
+  std::uint64_t                        source{};
+  std::uint64_t                        gate{};
+  std::uint64_t                        meta{};
+  std::map<std::string, std::uint64_t> uses{};
+};
+
+/**
+ * Record of the last compilation of every chip, saved as gates/manifest.
+ *
+ * Compiling a chip only depends on its HDL file and on the .meta files of
+ * the chips it uses, so as long as none of them changed (and its outputs
+ * were not touched) compiling it again would produce the same files.
+ */
+class BuildManifest
+{
+public:
+  static auto path() -> std::string;
+
+  /**
+   * Read the manifest, empty if there is none.
+   */
+  static auto load() -> BuildManifest;
+
+  auto save() const -> bool;
+
+  /**
+   * Content hash of a file, 0 if it can't be read.
+   */
+  static auto hash_file(const std::string& path) -> std::uint64_t;
+
+  /**
+   * True if compiling the chip again would not change anything.
+   */
+  auto is_up_to_date(const std::string& chip, const std::vector<std::string>& uses) const -> bool;
+
+  /**
+   * True if the chip was compiled before and its HDL file changed since.
+   */
+  auto is_source_changed(const std::string& chip) const -> bool;
+
+  /**
+   * Record the chip as just compiled, from its files as they are now.
+   */
+  void record(const std::string& chip, const std::vector<std::string>& uses);
+
+private:
+  std::map<std::string, ManifestEntry> entries{};
+};
+
+#endif /* BUILD_MANIFEST_H */
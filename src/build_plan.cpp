@@ -0,0 +1,227 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+
+#include "board.hpp"
+#include "build_manifest.hpp"
+#include "build_plan.hpp"
+#include "common.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+auto is_identifier(char c) -> bool
+{
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+} /* namespace */
+
+auto BuildPlan::parts_of(const std::string& hdl_path) -> std::vector<std::string>
+{
+  std::ifstream file{ hdl_path };
+  const std::string source{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+  // Drop the comments, they may mention chips.
+  std::string code{};
+  for (std::size_t i = 0; i < source.size(); i++)
+  {
+    if (source.compare(i, 2, "//") == 0)
+    {
+      i = std::min(source.find('\n', i), source.size()) - 1;
+    }
+    else if (source.compare(i, 2, "/*") == 0)
+    {
+      i = std::min(source.find("*/", i + 2), source.size() - 2) + 1;
+    }
+    else
+    {
+      code += source[i];
+    }
+  }
+
+  const auto parts = code.find("PARTS:");
+  if (parts == std::string::npos)
+  {
+    return {};
+  }
+
+  // Every identifier followed by '(' is a part.
+  std::vector<std::string> chips{};
+  for (auto i = parts + 6; i < code.size(); i++)
+  {
+    if (!is_identifier(code[i]) || is_identifier(code[i - 1]))
+    {
+      continue;
+    }
+
+    auto end = i;
+    while (end < code.size() && is_identifier(code[end])) end++;
+
+    auto next = end;
+    while (next < code.size() && std::isspace(static_cast<unsigned char>(code[next]))) next++;
+
+    if (next < code.size() && code[next] == '(')
+    {
+      auto chip = code.substr(i, end - i);
+      if (std::find(chips.begin(), chips.end(), chip) == chips.end())
+      {
+        chips.push_back(std::move(chip));
+      }
+
+      // Skip the connections.
+      end = code.find(')', next);
+      if (end == std::string::npos) break;
+    }
+
+    i = end;
+  }
+
+  return chips;
+}
+
+auto BuildPlan::scan() -> BuildPlan
+{
+  BuildPlan plan{};
+
+  std::error_code ec{};
+  for (const auto& entry : std::filesystem::directory_iterator(SCRIPTS_DIR, ec))
+  {
+    if (entry.path().extension() == HDL_EXTENSION)
+    {
+      plan.parts[entry.path().stem().string()] = parts_of(entry.path().string());
+    }
+  }
+
+  // Only chips with HDL of their own are built.
+  for (const auto& [chip, used] : plan.parts)
+  {
+    auto& dependencies = plan.graph[chip];
+    std::copy_if(used.begin(), used.end(), std::back_inserter(dependencies), [&](const std::string& dependency) { return plan.parts.contains(dependency); });
+  }
+
+  // Peel off the chips whose dependencies are all placed, whatever remains is cyclic.
+  std::set<std::string> placed{};
+  std::vector<std::string> remaining{};
+  for (const auto& [chip, _] : plan.graph) remaining.push_back(chip);
+
+  while (!remaining.empty())
+  {
+    std::vector<std::string> level{};
+    for (const auto& chip : remaining)
+    {
+      const auto& dependencies = plan.graph.at(chip);
+      if (std::all_of(dependencies.begin(), dependencies.end(), [&](const std::string& dependency) { return placed.contains(dependency); }))
+      {
+        level.push_back(chip);
+      }
+    }
+
+    if (level.empty())
+    {
+      plan.cyclic = std::move(remaining);
+      break;
+    }
+
+    placed.insert(level.begin(), level.end());
+    std::erase_if(remaining, [&](const std::string& chip) { return placed.contains(chip); });
+    plan.levels.push_back(std::move(level));
+  }
+
+  return plan;
+}
+
+auto BuildPlan::build(ThreadPool& pool, BuildManifest& manifest, bool force) const -> std::vector<BuildResult>
+{
+  std::map<std::string, BuildStatus> done{};
+  std::vector<BuildResult> results{};
+
+  for (const auto& level : levels)
+  {
+    std::vector<BuildResult> built(level.size());
+
+    // Chips of lower levels are done, 'done' is only read while the level runs.
+    pool.parallel_for(level.size(), [&](std::size_t i)
+    {
+      const auto& chip = level[i];
+      const auto& used = graph.at(chip);
+      auto& result = built[i];
+      result.chip = chip;
+
+      const auto failed = std::find_if(used.begin(), used.end(), [&](const std::string& dependency)
+      {
+        const auto status = done.at(dependency);
+        return status == BuildStatus::Failed || status == BuildStatus::Skipped;
+      });
+
+      if (failed != used.end())
+      {
+        result.status = BuildStatus::Skipped;
+        result.message = *failed;
+        return;
+      }
+
+      if (!force && manifest.is_up_to_date(chip, parts.at(chip)))
+      {
+        result.status = BuildStatus::UpToDate;
+        return;
+      }
+
+      const auto gate = GATE_RECIPE_DIRECTORY + chip + GATE_EXTENSION;
+      const auto before = BuildManifest::hash_file(gate);
+
+      std::ostringstream errors{};
+      result.status = Board::compile_recipe(chip, errors) ? BuildStatus::Compiled : BuildStatus::Failed;
+      result.message = errors.str();
+      result.changed = result.status == BuildStatus::Compiled && BuildManifest::hash_file(gate) != before;
+    });
+
+    for (auto& result : built)
+    {
+      if (result.status == BuildStatus::Compiled)
+      {
+        manifest.record(result.chip, parts.at(result.chip));
+      }
+
+      done[result.chip] = result.status;
+      results.push_back(std::move(result));
+    }
+  }
+
+  for (const auto& chip : cyclic)
+  {
+    results.push_back({ chip, BuildStatus::Failed, "Dependency cycle.\n" });
+  }
+
+  return results;
+}
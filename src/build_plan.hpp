@@ -0,0 +1,121 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef BUILD_PLAN_H
+#define BUILD_PLAN_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class BuildManifest;
+class ThreadPool;
+
+enum class BuildStatus
+{
+  Compiled,
+  UpToDate,
+  Failed,
+  Skipped
+};
+
+/**
+ * What a build did with a chip. The message holds the errors of a failed
+ * chip, or the name of the dependency a chip was skipped for. A compiled
+ * chip may not have changed, if only comments of its HDL did for example.
+ */
+struct BuildResult
+{
+  std::string chip{};
+  BuildStatus status{};
+  std::string message{};
+  bool        changed{};
+};
+
+/**
+ * The dependency graph of the HDL chips in the scripts directory, made from
+ * the chips each of them uses in its PARTS: section. Only chips which have an
+ * HDL file take part, builtins and other loaded chips are left out.
+ *
+ * Chips are grouped in levels, a chip only uses chips of lower levels, so
+ * all chips of a level can be compiled at the same time.
+ */
+class BuildPlan
+{
+public:
+  static auto scan() -> BuildPlan;
+
+  /**
+   * The chips used in the PARTS: section of an HDL file, without duplicates.
+   */
+  static auto parts_of(const std::string& hdl_path) -> std::vector<std::string>;
+
+  /**
+   * Compile the chips which are out of date according to the manifest (all
+   * of them when forced) into their .gate and .meta files, one level at a
+   * time and the chips of a level in parallel. Chips using a chip which
+   * failed are skipped. The compiled chips are recorded in the manifest,
+   * nothing is loaded. The results are in dependency order.
+   */
+  auto build(ThreadPool& pool, BuildManifest& manifest, bool force = false) const -> std::vector<BuildResult>;
+
+  /**
+   * The chips of the plan the chip uses.
+   */
+  auto dependencies(const std::string& chip) const -> const std::vector<std::string>&
+  {
+    return graph.at(chip);
+  }
+
+  /**
+   * Every chip the chip uses, builtins included.
+   */
+  auto get_parts(const std::string& chip) const -> const std::vector<std::string>&
+  {
+    return parts.at(chip);
+  }
+
+  auto get_levels() const -> const std::vector<std::vector<std::string>>&
+  {
+    return levels;
+  }
+
+  /**
+   * Chips which are part of (or use) a dependency cycle, they are never compiled.
+   */
+  auto get_cyclic() const -> const std::vector<std::string>&
+  {
+    return cyclic;
+  }
+
+private:
+  std::map<std::string, std::vector<std::string>> parts{};
+  std::map<std::string, std::vector<std::string>> graph{};
+  std::vector<std::vector<std::string>>           levels{};
+  std::vector<std::string>                        cyclic{};
+};
+
+#endif /* BUILD_PLAN_H */
@@ -0,0 +1,178 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "../gate.hpp"
+
+/**
+ * Native versions of the 16-bit chips from the HDL scripts (add_16, inc_16,
+ * alu, and_16, or_16, not_16). Their pins are laid out exactly like the HDL
+ * chips, which they replace while accelerated builtins are enabled.
+ */
+
+struct Add16 : Gate
+{
+  static constexpr std::string_view NAME{ "add_16" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * a[16], b[16].
+   */
+  using Layout = BusLayout<16, 16>;
+
+  explicit Add16()
+    : Gate(Layout::pin_count, 16, GateType::BUILTIN, std::string(NAME))
+  {
+  }
+
+  auto evaluate(BusWords& buses) -> std::uint64_t
+  {
+    return static_cast<BusWord>(buses[0] + buses[1]);
+  }
+};
+
+struct Inc16 : Gate
+{
+  static constexpr std::string_view NAME{ "inc_16" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * in[16].
+   */
+  using Layout = BusLayout<16>;
+
+  explicit Inc16()
+    : Gate(Layout::pin_count, 16, GateType::BUILTIN, std::string(NAME))
+  {
+  }
+
+  auto evaluate(BusWords& buses) -> std::uint64_t
+  {
+    return static_cast<BusWord>(buses[0] + 1);
+  }
+};
+
+struct And16 : Gate
+{
+  static constexpr std::string_view NAME{ "and_16" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * a[16], b[16].
+   */
+  using Layout = BusLayout<16, 16>;
+
+  explicit And16()
+    : Gate(Layout::pin_count, 16, GateType::BUILTIN, std::string(NAME))
+  {
+  }
+
+  auto evaluate(BusWords& buses) -> std::uint64_t
+  {
+    return buses[0] & buses[1];
+  }
+};
+
+struct Or16 : Gate
+{
+  static constexpr std::string_view NAME{ "or_16" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * a[16], b[16].
+   */
+  using Layout = BusLayout<16, 16>;
+
+  explicit Or16()
+    : Gate(Layout::pin_count, 16, GateType::BUILTIN, std::string(NAME))
+  {
+  }
+
+  auto evaluate(BusWords& buses) -> std::uint64_t
+  {
+    return buses[0] | buses[1];
+  }
+};
+
+struct Not16 : Gate
+{
+  static constexpr std::string_view NAME{ "not_16" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * in[16].
+   */
+  using Layout = BusLayout<16>;
+
+  explicit Not16()
+    : Gate(Layout::pin_count, 16, GateType::BUILTIN, std::string(NAME))
+  {
+  }
+
+  auto evaluate(BusWords& buses) -> std::uint64_t
+  {
+    return static_cast<BusWord>(~buses[0]);
+  }
+};
+
+struct Alu : Gate
+{
+  static constexpr std::string_view NAME{ "alu" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * x[16], y[16] and the control bits zx, nx, zy, ny, f, no as one 6-bit bus.
+   */
+  using Layout = BusLayout<16, 16, 6>;
+
+  explicit Alu()
+    : Gate(Layout::pin_count, 18, GateType::BUILTIN, std::string(NAME))
+  {
+  }
+
+  /**
+   * out[16], zr, ng.
+   */
+  auto evaluate(BusWords& buses) -> std::uint64_t
+  {
+    const auto [x_in, y_in, control, _, __] = buses;
+    const bool zx = control & 0b100000;
+    const bool nx = control & 0b010000;
+    const bool zy = control & 0b001000;
+    const bool ny = control & 0b000100;
+    const bool f  = control & 0b000010;
+    const bool no = control & 0b000001;
+
+    BusWord x = zx ? 0 : x_in;
+    BusWord y = zy ? 0 : y_in;
+    if (nx) x = static_cast<BusWord>(~x);
+    if (ny) y = static_cast<BusWord>(~y);
+
+    BusWord out = f ? static_cast<BusWord>(x + y) : static_cast<BusWord>(x & y);
+    if (no) out = static_cast<BusWord>(~out);
+
+    const std::uint64_t zr = (out == 0) ? 1 : 0;
+    const std::uint64_t ng = out >> 15;
+    return (static_cast<std::uint64_t>(out) << 2) | (zr << 1) | ng;
+  }
+};
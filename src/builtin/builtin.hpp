@@ -34,5 +34,7 @@
 #include "mux16.hpp"
 #include "register.hpp"
 #include "rom32k.hpp"
+#include "accelerated.hpp"
+#include "registry.hpp"
 
 #endif
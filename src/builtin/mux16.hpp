@@ -30,34 +30,26 @@
  */
 struct Mux16 : Gate 
 {
+  static constexpr std::string_view NAME{ "mux_16" };
+  static constexpr bool             STATEFUL{ false };
+
+  /**
+   * Two 16-bit inputs and the selector.
+   */
+  using Layout = BusLayout<16, 16, 1>;
+
   explicit Mux16()
     : Gate(
-        33,                 // Two 16-bit input, selector
+        Layout::pin_count,  // Two 16-bit input, selector
         16,                 // 16-bit output 
         GateType::MUX_16,   // Gate type
-        "mux_16"            // Gate name
+        std::string(NAME)   // Gate name
       )
   {
   }
 
-  auto sel_pin() -> Pin&
+  auto evaluate(BusWords& buses) -> BusWord
   {
-    return this->input_pins[32];
-  }
-
-  auto handle_mux_16_impl() -> void
-  {
-    std::size_t start{0}, end{16};
-
-
-    if (sel_pin().is_active())
-    {
-      start += 16;
-      end += 16;
-    }
-
-    const uint16_t value = pinvec_to_uint<uint16_t>(this->input_pins, start, end);
-    set_pinvec(value, this->output_pins, 0, 16);
+    return buses[2] ? buses[1] : buses[0];
   }
 };
-
@@ -26,53 +26,55 @@
 
 struct PC : Gate 
 {
+  static constexpr std::string_view NAME{ "pc" };
+  static constexpr bool             STATEFUL{ true };
+
+  /**
+   * 16-bit input, load, inc, reset and clock.
+   */
+  using Layout = BusLayout<16, 1, 1, 1, 1>;
+
   explicit PC()
     : Gate(
-        20,             // 16-bit input, load, inc, reset, clock
-        16,             // 16-bit output 
-        GateType::PC,   // Gate type
-        "pc"            // Gate name
+        Layout::pin_count,  // 16-bit input, load, inc, reset, clock
+        16,                 // 16-bit output 
+        GateType::PC,       // Gate type
+        std::string(NAME)   // Gate name
       ),
       register_value(0)
   {
   }
 
-
-  auto handle_pc_impl()  -> void
+  auto evaluate(BusWords& buses) -> BusWord
   {
-    if (!clock_pin().is_active()) action_taken = false;
+    auto& clock = buses[4];
+    if (!clock) action_taken = false;
 
-    if (forwardable())
+    if (forwardable(buses))
     {
-      if (reset_pin().is_active() && !action_taken)
+      if (buses[3] && !action_taken)
       {
         reset();
-        clock_pin().set_off();
+        clock = 0;
       }
-      else if (inc_pin().is_active() && !action_taken)
+      else if (buses[2] && !action_taken)
       {
         increment();
-        clock_pin().set_off();
+        clock = 0;
         action_taken = true;
       }
-      else if (load_pin().is_active() && !action_taken)
+      else if (buses[1] && !action_taken)
       {
-        load();
-        clock_pin().set_off();
+        this->register_value = buses[0];
+        clock = 0;
       }
-
-      sync_output();
-
     }
 
     // We don't want to continuously forward. 
     // Only forward once, when the signal turned from inactive to active.
-    previous_state = pinvec_to_uint(this->input_pins, 16, 20);
-  }
+    previous_state = control_state(buses);
 
-  auto sync_output() -> void
-  {
-    set_pinvec(this->register_value, this->output_pins, 0, 16);
+    return this->register_value;
   }
 
   auto increment() -> void
@@ -80,52 +82,29 @@ struct PC : Gate
     this->register_value++;
   }
 
-  auto load() -> void
-  {
-    this->register_value = pinvec_to_uint<uint16_t>(input_pins, 0, 16);
-  }
-
   auto reset() -> void
   {
     this->register_value = 0;
   }
 
-  auto forwardable() -> bool
-  {
-    const auto current_state = pinvec_to_uint(this->input_pins, 16, 20);
-    return previous_state != current_state 
-        && clock_pin().is_active();
-  }
-
-
-  inline auto load_pin() -> Pin&
-  {
-    return this->input_pins.at(16);
-  }
-
-  inline auto inc_pin() -> Pin&
+  /**
+   * The load, inc, reset and clock pins as a single value.
+   */
+  static auto control_state(const BusWords& buses) -> uint32_t
   {
-    return this->input_pins.at(17);
+    return (buses[1] << 3) | (buses[2] << 2) | (buses[3] << 1) | buses[4];
   }
 
-  inline auto reset_pin() -> Pin&
+  auto forwardable(const BusWords& buses) -> bool
   {
-    return this->input_pins.at(18);
+    return previous_state != control_state(buses) 
+        && buses[4];
   }
 
-  inline auto clock_pin() -> Pin&
-  {
-    return this->input_pins.at(19);
-  }
-   
   /*
    * 
    */
   uint16_t register_value { 0 };
-  PinState previous_clock_state { PinState::INACTIVE };
   bool     action_taken { false };
   uint32_t previous_state { 0 };
 }; 
-
-
-
@@ -26,67 +26,41 @@
 
 struct Ram16k : Gate 
 {
+  static constexpr std::string_view NAME{ "ram_16k" };
+  static constexpr bool             STATEFUL{ true };
+
+  /**
+   * 16-bit input, 14-bit address, load and clock.
+   */
+  using Layout = BusLayout<16, 14, 1, 1>;
+
   explicit Ram16k()
     : Gate(
-        32,                 // 16-bit input, 14-bit address, load, clock
+        Layout::pin_count,  // 16-bit input, 14-bit address, load, clock
         16,                 // 16-bit output 
         GateType::RAM_16K,  // Gate type
-        "ram_16k"           // Gate name
+        std::string(NAME)   // Gate name
       )
   {
   }
 
-  auto read_in() -> uint16_t
-  {
-    return pinvec_to_uint<uint16_t>(this->input_pins, 0, 16);
-  }
-
-  auto read_address() -> std::size_t
-  {
-    return pinvec_to_uint<uint16_t>(this->input_pins, 16, 30);
-  }
-
-  auto load_pin() -> Pin&
-  {
-    return this->input_pins[30];
-  }
-
-  auto clock_pin() -> Pin&
-  {
-    return this->input_pins[31];
-  }
-
-  auto sync_output() -> void
+  auto evaluate(BusWords& buses) -> BusWord
   {
-    const auto value = data[address];
-    set_pinvec(value, this->output_pins, 0, 16);
-  }
+    const auto [in, address_bus, load, clock, _] = buses;
 
-  auto load_value() -> void
-  {
-    const auto value = read_in();
-    data[address] = value;
-    // std::cout << "LOAD[" << address << "] " << value << '\n';
-  }
-
-  auto handle_ram_16k_impl() -> void
-  {
-    // std::cout << "Clock[" << clock_pin().is_active() << "], Load[" << load_pin().is_active() << "]\n";
     // Set the new address
-    address = read_address();
-
+    address = address_bus;
 
     // Load value into address
-    if (!immutable && clock_pin().is_active() && load_pin().is_active())
+    if (!immutable && clock && load)
     {
-      load_value();
+      data[address] = in;
     }
 
     // State can ONLY be written ONCE per clock cycle.
-    immutable = clock_pin().is_active();
+    immutable = clock != 0;
 
-    // Synchronize output pins
-    sync_output();
+    return data[address];
   }
 
   /*
@@ -96,4 +70,3 @@ struct Ram16k : Gate
     uint16_t    data[16384] {0};
     bool immutable { false };
 };
-
@@ -26,88 +26,57 @@
 
 struct Register : Gate
 {
+  static constexpr std::string_view NAME{ "register" };
+  static constexpr bool             STATEFUL{ true };
+
+  /**
+   * 16-bit input, load and clock.
+   */
+  using Layout = BusLayout<16, 1, 1>;
+
   explicit Register()
     : Gate(
-        18,                 // 16-bit input, load, clock
+        Layout::pin_count,  // 16-bit input, load, clock
         16,                 // 16-bit output 
         GateType::REGISTER, // Gate type
-        "register"          // Gate name
+        std::string(NAME)   // Gate name
       )
   {
   }
 
-  auto load_pin() -> Pin& 
-  {
-    return this->input_pins[16];
-  }
-
-  auto clock_pin() -> Pin& 
-  {
-    return this->input_pins[17];
-  }
-
-  auto load_value() -> uint16_t 
-  {
-    return pinvec_to_uint(this->input_pins, 0, 16);
-  }
-
   // There is a big problem with this.
   // We don't know which signal arrives first,
   // and we don't know which signal might be out-dated.
-  auto handle_register_impl() -> void
+  auto evaluate(BusWords& buses) -> BusWord
   {
-    const uint16_t loaded_value = load_value();
-
-    // std::cout << "========[ Register " << std::hex << (reinterpret_cast<uint64_t>(this) & 0xFFFF) << " ]========\n";
-    // std::cout << std::dec;
-    // std::cout << "Value: " << loaded_value << '\n';
-    // std::cout << "Load: " << load_pin().is_active() << '\n';
-    // std::cout << "Clock: " << clock_pin().is_active() << '\n';
+    const BusWord loaded_value = buses[0];
+    auto& load = buses[1];
+    const bool clock = buses[2] != 0;
 
     // Data can only be stored on a new clock signal.
-    if (clock_pin().is_active())
+    if (clock)
     {
       const auto new_value_loaded = loaded_value != this->data;
-      const auto load_pin_active = load_pin().is_active();
-      const auto new_load_state = load_pin().get_state() != previous_load_state;
 
-      if (new_value_loaded && load_pin_active && (written < 1))
+      if (new_value_loaded && load && (written < 1))
       {
         this->data = loaded_value;
-        // std::cout << "Setting value: " << this->data << '\n';
-
-        set_pinvec(loaded_value, this->output_pins, 0, 16);
-
-        // std::cout << "\n [ WRITTEN ]\n";
-
-        // load_pin().set_off();
-
         written++;
       }
     }
 
-    if (!clock_pin().is_active())
+    if (!clock)
     {
-      // std::cout << "[ WRITTEN RESET ]" << '\n';
       written = 0;
-      load_pin().set_off();
+      load = 0;
     }
 
-    previous_load_state = load_pin().get_state();
-    previous_clock_state = clock_pin().get_state();
-  }
-
-  auto commit() -> bool
-  {
-    return previous_clock_state == PinState::ACTIVE && !clock_pin().is_active();
+    return this->data;
   }
 
   /**
    * Members
    */
-  PinState previous_clock_state { PinState::INACTIVE };
-  PinState previous_load_state  { PinState::INACTIVE };
   uint8_t  written              { 0 };
-  uint16_t data;
+  uint16_t data                 { 0 };
 };
-
@@ -0,0 +1,210 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef BUILTIN_REGISTRY_H
+#define BUILTIN_REGISTRY_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../common.hpp"
+#include "../utils.hpp"
+
+struct Gate;
+
+/**
+ * Dense index of a registered builtin.
+ */
+using BuiltinOpcode = std::uint16_t;
+
+constexpr BuiltinOpcode NO_BUILTIN{ std::numeric_limits<BuiltinOpcode>::max() };
+
+/**
+ * Creates a fresh builtin, with its opcode set.
+ */
+using BuiltinFactory = auto (*)() -> std::unique_ptr<Gate>;
+
+/**
+ * Runs a builtin on its inputs, one byte (0 or 1) per input pin. The outputs
+ * are returned packed MSB first, like the rows of a truth table. A builtin may
+ * clear some of its inputs (a consumed clock edge for instance), the engine
+ * decides whether that is kept.
+ */
+using BuiltinEvaluator = auto (*)(Gate& gate, std::span<std::uint8_t> inputs) -> std::uint64_t;
+
+struct BuiltinInfo
+{
+  std::string      name;
+  BuiltinFactory   create;
+  BuiltinEvaluator evaluate;
+  bool             stateful;
+  std::size_t      size;
+  bool             accelerator{};
+};
+
+/**
+ * Every builtin gate type, indexed by opcode. Duplicating or evaluating a
+ * builtin is a lookup in this table.
+ *
+ * The builtins of the simulator are registered when the registry is first
+ * used, more can be added with add<T>() before the Board is created. A
+ * builtin type T derives from Gate and provides:
+ *
+ * - NAME:     The name it is instantiated by.
+ * - STATEFUL: Whether it holds state, stateful builtins break feedback loops.
+ * - Layout:   Its input buses (a BusLayout) and evaluate(BusWords&), which
+ *   returns the packed outputs, unless an evaluator is given to add().
+ *
+ * Accelerators (add_accelerator<T>()) are native versions of chips which
+ * are otherwise defined in HDL. They only replace the HDL chip of the same
+ * name while the board has accelerated builtins enabled.
+ */
+class BuiltinRegistry
+{
+public:
+  static auto instance() -> BuiltinRegistry&;
+
+  template <typename T>
+  auto add(BuiltinEvaluator evaluate = &evaluate_buses<T>) -> BuiltinOpcode
+  {
+    const auto opcode = insert<T>(evaluate, false);
+    if (opcode != NO_BUILTIN) names[std::string(T::NAME)] = opcode;
+    return opcode;
+  }
+
+  template <typename T>
+  auto add_accelerator(BuiltinEvaluator evaluate = &evaluate_buses<T>) -> BuiltinOpcode
+  {
+    const auto opcode = insert<T>(evaluate, true);
+    if (opcode != NO_BUILTIN) accelerators[std::string(T::NAME)] = opcode;
+    return opcode;
+  }
+
+  /**
+   * The opcode of the builtin with the given name, NO_BUILTIN if there is none.
+   */
+  auto find(std::string_view name) const -> BuiltinOpcode
+  {
+    const auto it = names.find(name);
+    return it == names.end() ? NO_BUILTIN : it->second;
+  }
+
+  /**
+   * The opcode of the accelerator for the given HDL chip, NO_BUILTIN if there is none.
+   */
+  auto find_accelerator(std::string_view name) const -> BuiltinOpcode
+  {
+    const auto it = accelerators.find(name);
+    return it == accelerators.end() ? NO_BUILTIN : it->second;
+  }
+
+  auto get(BuiltinOpcode opcode) const -> const BuiltinInfo&
+  {
+    return builtins[opcode];
+  }
+
+  auto get_builtins() const -> const std::vector<BuiltinInfo>&
+  {
+    return builtins;
+  }
+
+  /**
+   * A fresh builtin with the given name, nullptr if there is none.
+   */
+  auto create(std::string_view name) const -> std::unique_ptr<Gate>
+  {
+    const auto opcode = find(name);
+    if (opcode == NO_BUILTIN)
+    {
+      error("No builtin named '" + std::string(name) + "'.");
+      return nullptr;
+    }
+    return builtins[opcode].create();
+  }
+
+  /**
+   * The evaluator of a builtin which works on buses: the inputs are packed with
+   * T::Layout and the cleared control inputs are unpacked back.
+   */
+  template <typename T>
+  static auto evaluate_buses(Gate& gate, std::span<std::uint8_t> inputs) -> std::uint64_t
+  {
+    using Layout = typename T::Layout;
+
+    auto buses = Layout::pack([&](std::size_t i) { return inputs[i] != 0; });
+    const std::uint64_t value = static_cast<T&>(gate).evaluate(buses);
+    Layout::unpack(buses, [&](std::size_t i, bool on) { inputs[i] = on ? 1 : 0; });
+
+    return value;
+  }
+
+private:
+  BuiltinRegistry() = default;
+
+  template <typename T>
+  auto insert(BuiltinEvaluator evaluate, bool accelerator) -> BuiltinOpcode
+  {
+    if (std::make_unique<T>()->input_pins.size() > BUILTIN_INPUT_LIMIT)
+    {
+      error("Builtin '" + std::string(T::NAME) + "' has too many inputs.");
+      return NO_BUILTIN;
+    }
+
+    const auto opcode = static_cast<BuiltinOpcode>(builtins.size());
+    opcode_of<T> = opcode;
+
+    builtins.push_back({
+      .name = std::string(T::NAME),
+      .create = []() -> std::unique_ptr<Gate>
+      {
+        auto gate = std::make_unique<T>();
+        gate->opcode = opcode_of<T>;
+        return gate;
+      },
+      .evaluate = evaluate,
+      .stateful = T::STATEFUL,
+      .size = sizeof(T),
+      .accelerator = accelerator,
+    });
+
+    return opcode;
+  }
+
+  template <typename T>
+  static inline BuiltinOpcode opcode_of{ NO_BUILTIN };
+
+  std::vector<BuiltinInfo>                       builtins{};
+  NameIndex<BuiltinOpcode>                       names{};
+  NameIndex<BuiltinOpcode>                       accelerators{};
+};
+
+#endif /* BUILTIN_REGISTRY_H */
@@ -26,69 +26,40 @@
 
 struct Rom32k : Gate 
 {
+  static constexpr std::string_view NAME{ "rom_32k" };
+  static constexpr bool             STATEFUL{ true };
+
+  /**
+   * 16-bit input, 15-bit read address, 15-bit write address, load and clock.
+   */
+  using Layout = BusLayout<16, 15, 15, 1, 1>;
+
   // NOTE: The input is supposed to be only one 15-bit input bus for address,
   // but here we have extra for testing purposes.
   explicit Rom32k()
     : Gate(
-        48,                 // 16-bit input, 15-bit address (read), 15-bit address (write), load, clock
+        Layout::pin_count,  // 16-bit input, 15-bit address (read), 15-bit address (write), load, clock
         16,                 // 16-bit output 
         GateType::ROM_32K,  // Gate type
-        "rom_32k"           // Gate name
+        std::string(NAME)   // Gate name
       )
   {
   }
 
-  auto read_in() -> uint16_t
+  auto evaluate(BusWords& buses) -> BusWord
   {
-    return pinvec_to_uint<uint16_t>(this->input_pins, 0, 16);
-  }
-
-  auto read_address() -> std::size_t
-  {
-    return pinvec_to_uint<uint16_t>(this->input_pins, 16, 31);
-  }
-
-  auto write_address() -> std::size_t
-  {
-    return pinvec_to_uint<uint16_t>(this->input_pins, 31, 46);
-  }
-
-  auto load_pin() -> Pin&
-  {
-    return this->input_pins[46];
-  }
+    const auto [in, read_address, write_address, load, clock] = buses;
 
-  auto clock_pin() -> Pin&
-  {
-    return this->input_pins[47];
-  }
-
-  auto sync_output() -> void
-  {
-    const auto value = data[address];
-    set_pinvec(value, this->output_pins, 0, 16);
-  }
-
-  auto load_value() -> void
-  {
-    const auto value = read_in();
-    const auto address = write_address();
-    data[address] = value;
-  }
-
-  auto handle_rom_32k_impl() -> void
-  {
     // Set the new address
-    address = read_address();
+    address = read_address;
 
     // Load value into address
-    if (clock_pin().is_active() && load_pin().is_active())
+    if (clock && load)
     {
-      load_value();
+      data[write_address] = in;
     }
 
-    // Synchronize output pins
-    sync_output();
+    return data[address];
   }
 
   /*
@@ -97,5 +68,3 @@ struct Rom32k : Gate
     std::size_t address     {0};
     uint16_t    data[32768] {0};
 };
-
-
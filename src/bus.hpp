@@ -0,0 +1,122 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef BUS_H
+#define BUS_H
+
+#include <array>
+#include <cstdint>
+#include <utility>
+
+/**
+ * A bus of up to 16 bits held in a single word. Like HDL buses, the first
+ * pin of a bus is its most significant bit.
+ */
+using BusWord = std::uint16_t;
+
+/**
+ * The most buses a builtin reads (Rom32k: in, read address, write address, load, clock).
+ */
+constexpr std::size_t MAX_BUS_COUNT{ 5 };
+
+using BusWords = std::array<BusWord, MAX_BUS_COUNT>;
+
+/**
+ * Read 'Width' consecutive bits, starting at 'Offset', into a word. The loop
+ * is unrolled at compile time, 'bit(i)' returns the i-th bit.
+ */
+template <std::size_t Offset, std::size_t Width, typename BitSource>
+constexpr auto extract_bus(BitSource&& bit) -> BusWord
+{
+  static_assert(Width <= 16, "A bus is at most 16 bits wide.");
+
+  return [&]<std::size_t... I>(std::index_sequence<I...>)
+  {
+    return static_cast<BusWord>(((static_cast<unsigned>(bit(Offset + I) ? 1 : 0) << (Width - 1 - I)) | ... | 0u));
+  }(std::make_index_sequence<Width>{});
+}
+
+/**
+ * Write a word into 'Width' consecutive bits starting at 'Offset' through 'set(i, bit)'.
+ */
+template <std::size_t Offset, std::size_t Width, typename BitSink>
+constexpr auto insert_bus(BusWord value, BitSink&& set) -> void
+{
+  static_assert(Width <= 16, "A bus is at most 16 bits wide.");
+
+  [&]<std::size_t... I>(std::index_sequence<I...>)
+  {
+    (set(Offset + I, ((value >> (Width - 1 - I)) & 1) != 0), ...);
+  }(std::make_index_sequence<Width>{});
+}
+
+/**
+ * The fixed layout of a builtin's input pins, one width per bus, in pin order.
+ */
+template <std::uint8_t... Widths>
+struct BusLayout
+{
+  static constexpr std::size_t bus_count{ sizeof...(Widths) };
+  static_assert(bus_count <= MAX_BUS_COUNT, "Too many buses.");
+
+  static constexpr std::array<std::uint8_t, bus_count> widths{ Widths... };
+  static constexpr std::size_t pin_count{ (Widths + ... + 0) };
+
+  /**
+   * The first pin of every bus.
+   */
+  static constexpr std::array<std::size_t, bus_count> offsets = []
+  {
+    std::array<std::size_t, bus_count> result{};
+    std::size_t offset{ 0 };
+    for (std::size_t bus = 0; bus < bus_count; bus++)
+    {
+      result[bus] = offset;
+      offset += widths[bus];
+    }
+    return result;
+  }();
+
+  template <typename BitSource>
+  static constexpr auto pack(BitSource&& bit) -> BusWords
+  {
+    return [&]<std::size_t... Bus>(std::index_sequence<Bus...>)
+    {
+      return BusWords{ extract_bus<offsets[Bus], widths[Bus]>(bit)... };
+    }(std::make_index_sequence<bus_count>{});
+  }
+
+  template <typename BitSink>
+  static constexpr auto unpack(const BusWords& buses, BitSink&& set) -> void
+  {
+    [&]<std::size_t... Bus>(std::index_sequence<Bus...>)
+    {
+      (insert_bus<offsets[Bus], widths[Bus]>(buses[Bus], set), ...);
+    }(std::make_index_sequence<bus_count>{});
+  }
+};
+
+#endif /* BUS_H */
@@ -26,7 +26,9 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <functional>
 #include <string>
+#include <thread>
 
 /**
  * Attributes related to saving gate information.
@@ -34,9 +36,13 @@
 constexpr const char* DEFAULT_GATE_DIRECTORY{ "gates" };
 constexpr const char* DEFAULT_RECIPE_SAVE_DIRECTORY{ "sketches" };
 constexpr const char* GATE_EXTENSION{ ".gate" };
+constexpr const char* GATE_BINARY_EXTENSION{ ".gateb" };
 constexpr const char* META_EXTENSION{ ".meta" };
 constexpr const char* HDL_EXTENSION{ ".hdl" };
 constexpr const char* TEST_EXTENSION{ ".tst" };
+constexpr const char* TABLE_CACHE_DIRECTORY{ "tables" };
+constexpr const char* TABLE_EXTENSION{ ".table" };
+constexpr const char* MANIFEST_FILE{ "manifest" };
 constexpr const std::size_t TOOLBOX_WIDTH = 150;
 constexpr const std::size_t TOOLBOX_X_MARGIN = 7.f;
 constexpr const std::size_t TOOLBOX_TOP_MARGIN = 20.f;
@@ -51,12 +57,38 @@ inline auto hdl_file(const std::string& name) -> std::string
  return std::move(SCRIPTS_DIR + SEPERATOR + name + HDL_EXTENSION);
 }
 
+/**
+ * Temporary file a writer saves to before renaming it onto 'path'. It is
+ * unique per thread, so concurrent writers of a file never share one.
+ */
+inline auto temporary_file(const std::string& path) -> std::string
+{
+ return path + "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+}
+
 /**
  * Max number of input pins, referring to a pin ID bigger than 
  * this number will return an output pin.
  */
 constexpr std::size_t INPUT_PIN_LIMIT{ 1000 };
 
+/**
+ * Bound on the work a compiled circuit does per tick while waiting for its
+ * feedback loops to settle, in multiples of its instruction count.
+ */
+constexpr std::size_t SETTLE_PASS_LIMIT{ 64 };
+
+/**
+ * Widest chip (in input pins) which gets serialized, a truth table has
+ * 2^n rows so anything wider would take too long and use too much memory.
+ */
+constexpr std::size_t SERIALIZE_INPUT_LIMIT{ 24 };
+
+/**
+ * Most input pins a registered builtin can have.
+ */
+constexpr std::size_t BUILTIN_INPUT_LIMIT{ 64 };
+
 /**
  * GUI wire's signal speed.
  */
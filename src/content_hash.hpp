@@ -0,0 +1,88 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * Incremental 64-bit FNV-1a hash, used to identify the content of gates
+ * and files across runs (so it must never depend on addresses or the platform).
+ */
+class ContentHash
+{
+public:
+  auto add(std::string_view bytes) -> ContentHash&
+  {
+    for (const auto byte : bytes)
+    {
+      state ^= static_cast<std::uint8_t>(byte);
+      state *= PRIME;
+    }
+    return *this;
+  }
+
+  auto add(std::uint64_t value) -> ContentHash&
+  {
+    for (int i = 0; i < 8; i++)
+    {
+      state ^= (value >> (i * 8)) & 0xFF;
+      state *= PRIME;
+    }
+    return *this;
+  }
+
+  auto value() const -> std::uint64_t
+  {
+    return state;
+  }
+
+  /**
+   * Fixed width hexadecimal representation, suitable for file names.
+   */
+  static auto to_hex(std::uint64_t hash) -> std::string
+  {
+    constexpr const char* digits = "0123456789abcdef";
+
+    std::string hex(16, '0');
+    for (int i = 15; i >= 0; i--, hash >>= 4)
+    {
+      hex[i] = digits[hash & 0xF];
+    }
+    return hex;
+  }
+
+private:
+  static constexpr std::uint64_t OFFSET_BASIS{ 0xcbf29ce484222325ULL };
+  static constexpr std::uint64_t PRIME{ 0x100000001b3ULL };
+
+  std::uint64_t state{ OFFSET_BASIS };
+};
+
+#endif /* CONTENT_HASH_H */
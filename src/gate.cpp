@@ -24,7 +24,9 @@
 
 #include "gate.hpp"
 #include "board.hpp"
-#include "wire.hpp"
+#include "netlist.hpp"
+#include "parallel_circuit.hpp"
+#include "thread_pool.hpp"
 
 /**
  * Builtin Gates
@@ -34,12 +36,164 @@
 std::size_t Gate::add_subgate(std::string_view gate_name, Board* board)
 {
   auto board_instance = (board == nullptr) ? Board::instance() : board;
-  auto key = subgate_count++;
 	auto gate = board_instance->get_component(gate_name);
-  subgates.push_back(gate->duplicate(board));
+  return attach_subgate(gate->duplicate(board_instance));
+}
+
+auto Gate::attach_subgate(std::unique_ptr<Gate> subgate) -> std::size_t
+{
+  auto key = subgate_count++;
+  subgates.push_back(std::move(subgate));
+  input_offsets.push_back(input_offsets.back() + subgates.back()->input_pins.size());
+  output_offsets.push_back(output_offsets.back() + subgates.back()->output_pins.size());
   return key;
 }
 
+bool Gate::serialize(std::size_t input_limit)
+{
+  if (input_pins.size() > input_limit || output_pins.size() > TruthTable::MAX_WIDTH)
+  {
+    return false;
+  }
+
+  uint64_t indicies = (2ULL << (static_cast<uint64_t>(input_pins.size()) - 1));
+
+  // The truth table is generated by the compiled engine, it is
+  // only built once instead of being re-walked for every row.
+  auto netlist = Netlist::compile(*this);
+
+  // Filled separately, the copies of an already serialized gate still read the old table.
+  TruthTable table(output_pins.size(), indicies);
+
+  auto& pool = ThreadPool::instance();
+  const auto partitioned = netlist->is_combinational() && pool.size() > 1;
+
+  if (ParallelCircuit::supports(*netlist))
+  {
+    // Every worker gets its own lanes, the netlist itself is shared.
+    const auto lanes = ParallelCircuit::preferred_words() * ParallelCircuit::WORD_LANES;
+    const auto per_chunk = partitioned ? std::max<uint64_t>(lanes, indicies / (pool.size() * 4)) : indicies;
+    const auto chunk = (per_chunk + lanes - 1) / lanes * lanes;
+    const auto chunks = (indicies + chunk - 1) / chunk;
+
+    pool.parallel_for(chunks, [&](std::size_t i)
+    {
+      serialize_parallel(netlist, table, i * chunk, std::min(indicies, (i + 1) * chunk));
+    });
+  }
+  else if (partitioned)
+  {
+    // Builtins keep their pins inside of the gate, so every worker simulates its own copy.
+    // Chunks are whole blocks of rows so that workers never share a word of the table.
+    const auto blocks = (indicies + TruthTable::ALIGNED_ROWS - 1) / TruthTable::ALIGNED_ROWS;
+    const auto chunks = std::min<uint64_t>(pool.size(), blocks);
+    const auto chunk = (blocks + chunks - 1) / chunks * TruthTable::ALIGNED_ROWS;
+
+    std::vector<std::unique_ptr<Gate>> copies{};
+    for (uint64_t i = 0; i < chunks; i++)
+    {
+      copies.push_back(duplicate());
+    }
+
+    pool.parallel_for(chunks, [&](std::size_t i)
+    {
+      serialize_stepped(*copies[i], Netlist::compile(*copies[i]), table, i * chunk, std::min(indicies, (i + 1) * chunk));
+    });
+  }
+  else
+  {
+    // State carries over from one row to the next, so the rows are stepped in order.
+    serialize_stepped(*this, std::move(netlist), table, 0, indicies);
+  }
+
+  use_table(std::move(table));
+  return true;
+}
+
+void Gate::serialize_parallel(std::shared_ptr<const Netlist> netlist, TruthTable& table, uint64_t first, uint64_t last)
+{
+  // Small tables do not need more than a single word per net.
+  const auto words = (last - first > ParallelCircuit::WORD_LANES) ? ParallelCircuit::preferred_words() : 1;
+  ParallelCircuit circuit{ std::move(netlist), words };
+
+  const auto inputs = input_pins.size();
+  const auto outputs = output_pins.size();
+  const auto lanes = circuit.lane_count();
+
+  // Row 'i' is the input vector 'i', so a pass evaluates as many consecutive rows as there are lanes.
+  for (uint64_t base = first; base < last; base += lanes)
+  {
+    for (std::size_t word = 0; word < words; word++)
+    {
+      for (std::size_t i = 0; i < inputs; i++)
+      {
+        const auto row = base + word * ParallelCircuit::WORD_LANES;
+        circuit.set_input(i, word, ParallelCircuit::counting_lanes(inputs - 1 - i, row));
+      }
+    }
+
+    circuit.evaluate();
+
+    const auto rows = std::min<uint64_t>(lanes, last - base);
+    for (uint64_t lane = 0; lane < rows; lane++)
+    {
+      const auto word = lane / ParallelCircuit::WORD_LANES;
+      const auto bit = lane % ParallelCircuit::WORD_LANES;
+
+      std::size_t row{ 0 };
+      for (std::size_t o = 0; o < outputs; o++)
+      {
+        row = (row << 1) | ((circuit.get_output(o, word) >> bit) & 1);
+      }
+      table.set(base + lane, row);
+    }
+  }
+}
+
+void Gate::serialize_stepped(Gate& gate, std::shared_ptr<const Netlist> netlist, TruthTable& table, uint64_t first, uint64_t last)
+{
+  CompiledCircuit circuit{ gate, std::move(netlist) };
+
+  for (uint64_t i = first; i < last; i++)
+  {
+    gate.apply_input(gate.input_pins.size(), static_cast<std::size_t>(i));
+    circuit.step();
+    table.set(i, gate.serialize_output());
+  }
+}
+
+std::size_t Gate::memory_usage() const
+{
+  std::size_t bytes = sizeof(Gate) + name.capacity();
+
+  // Builtins keep their state in members past the Gate itself.
+  if (opcode != NO_BUILTIN && type != GateType::CUSTOM)
+  {
+    bytes += BuiltinRegistry::instance().get(opcode).size - sizeof(Gate);
+  }
+
+  for (const auto& pins : { &input_pins, &output_pins })
+  {
+    bytes += pins->capacity() * sizeof(Pin);
+    for (const auto& pin : *pins)
+    {
+      bytes += pin.connections.capacity() * sizeof(Wire*);
+    }
+  }
+
+  bytes += wires.size() * sizeof(Wire);
+  bytes += serialized_computation.memory_usage();
+  bytes += subgates.capacity() * sizeof(std::unique_ptr<Gate>);
+  bytes += (input_offsets.capacity() + output_offsets.capacity()) * sizeof(std::size_t);
+
+  for (const auto& subgate : subgates)
+  {
+    bytes += subgate->memory_usage();
+  }
+
+  return bytes;
+}
+
 void Gate::handle_custom_type(std::unordered_set<Gate*> was_visited)
 {
   was_visited.insert(this);
@@ -50,23 +204,30 @@ void Gate::handle_custom_type(std::unordered_set<Gate*> was_visited)
     return;
   }
 
-  std::vector<Pin> to_explore{ input_pins };
+  std::vector<Pin*> to_explore{};
+  for (auto& pin : input_pins)
+  {
+    to_explore.push_back(&pin);
+  }
   std::vector<Gate*> gates{};
-  std::size_t n {0};
 
-  while( !to_explore.empty() )
+  // A combinational loop may never settle, bound the rounds spent waiting for it.
+  const std::size_t round_limit { SETTLE_PASS_LIMIT * (subgates.size() + 1) };
+  std::size_t rounds {0};
+
+  while( !to_explore.empty() && rounds++ < round_limit )
   {
-    std::vector<Pin> exploring = std::move(to_explore);
-    int index {0};
+    std::vector<Pin*> exploring = std::move(to_explore);
+    std::size_t index {0};
 
     // Keep exploring until we reach a deadend or a parent component.
     while ( index < exploring.size() )
     {
       // Grab the pin we're interested in.
-      auto pin = exploring.at(index++);
+      auto* pin = exploring.at(index++);
 
       // Add the pins it is connected to.
-      for (auto& conn : pin.connections)
+      for (auto& conn : pin->connections)
       {
         if (conn->output == nullptr) continue;
 
@@ -85,7 +246,7 @@ void Gate::handle_custom_type(std::unordered_set<Gate*> was_visited)
 
         if (!conn->output->has_parent())
         {
-          exploring.push_back(*conn->output);
+          exploring.push_back(conn->output);
         }
         else if (!was_visited.contains(conn->output->parent))
         {
@@ -99,10 +260,11 @@ void Gate::handle_custom_type(std::unordered_set<Gate*> was_visited)
       if (was_visited.count(gate) == 0)
       {
         was_visited.insert(gate);
+        // Its own copy, exploring its outputs continues into the wires of this gate.
         gate->simulate(was_visited);
-        for (auto& output_pins : gate->output_pins)
+        for (auto& output_pin : gate->output_pins)
         {
-          to_explore.push_back(output_pins);
+          to_explore.push_back(&output_pin);
         }
       }
     }
@@ -112,8 +274,8 @@ void Gate::handle_custom_type(std::unordered_set<Gate*> was_visited)
 
 bool Gate::connect_pins(Pin* input, Pin* output)
 {
-  input->connections.push_back(std::make_shared<Wire>(input, output));
-  wires.push_back(input->connections.back().get());
+  auto& wire = wires.emplace_back(input, output);
+  input->connections.push_back(&wire);
   return true;
 }
 
@@ -124,49 +286,41 @@ void Gate::simulate(std::unordered_set<Gate*> was_visited)
   {
     break; case GateType::NAND: handle_nand();
     break; case GateType::DFF: handle_dff();
-    break; case GateType::PC: handle_pc();
-    break; case GateType::RAM_16K: handle_ram_16k();
-    break; case GateType::ROM_32K: handle_rom_32k();
-    break; case GateType::MUX_16: handle_mux_16();
-    break; case GateType::REGISTER: handle_register();
     break; case GateType::CUSTOM: handle_custom_type(was_visited);
-    break; default: log("Invalid type...?\n");
+    break; default: 
+    {
+      if (opcode == NO_BUILTIN) log("Invalid type...?\n");
+      else handle_builtin();
+    }
   }
 }
 
-void Gate::handle_pc()
+auto Gate::handle_builtin() -> void
 {
-  static_cast<PC*>(this)->handle_pc_impl();
-}
-
-auto Gate::handle_register() -> void 
-{
- static_cast<Register*>(this)->handle_register_impl(); 
-}
+  std::array<std::uint8_t, BUILTIN_INPUT_LIMIT> inputs{};
+  for (std::size_t i = 0; i < input_pins.size(); i++)
+  {
+    inputs[i] = input_pins[i].is_active() ? 1 : 0;
+  }
 
-void Gate::handle_ram_16k()
-{
-  static_cast<Ram16k*>(this)->handle_ram_16k_impl();
-}
+  const auto row = BuiltinRegistry::instance().get(opcode).evaluate(*this, { inputs.data(), input_pins.size() });
 
-void Gate::handle_rom_32k()
-{
-  static_cast<Rom32k*>(this)->handle_rom_32k_impl();
-}
+  // Keep whatever control inputs the builtin cleared (a consumed clock edge, for instance).
+  for (std::size_t i = 0; i < input_pins.size(); i++)
+  {
+    input_pins[i].state = inputs[i] ? PinState::ACTIVE : PinState::INACTIVE;
+  }
 
-auto Gate::handle_mux_16() -> void 
-{
-  static_cast<Mux16*>(this)->handle_mux_16_impl();
+  const auto count = output_pins.size();
+  for (std::size_t i = 0; i < count; i++)
+  {
+    output_pins[i].state = ((row >> (count - 1 - i)) & 1) ? PinState::ACTIVE : PinState::INACTIVE;
+  }
 }
 
 std::unique_ptr<Gate> Gate::duplicate(Board* board)
 {
-  // Really ugly but it must be done.
-  if (this->name == "pc") return std::make_unique<PC>();
-  else if (this->name == "ram_16k") return std::make_unique<Ram16k>();
-  else if (this->name == "rom_32k") return std::make_unique<Rom32k>();
-  else if (this->name == "mux_16") return std::make_unique<Mux16>();
-  else if (this->name == "register") return std::make_unique<Register>();
+  if (opcode != NO_BUILTIN) return BuiltinRegistry::instance().get(opcode).create();
 
   auto g = std::make_unique<Gate>(input_pins.size(), output_pins.size(), this->type, this->name, this->serialized);
 
@@ -182,7 +336,8 @@ std::unique_ptr<Gate> Gate::duplicate(Board* board)
     // Add the subgates and copy the wiring.
     for (std::size_t i = 0; i < subgate_count; i++)
     {
-      g->add_subgate(subgates.at(i)->name, board);
+      if (board != nullptr) g->add_subgate(subgates.at(i)->name, board);
+      else g->attach_subgate(subgates.at(i)->duplicate());
     }
 
     g->construct_wire(this->wire_construction_recipe);
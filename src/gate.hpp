@@ -26,13 +26,20 @@
 #ifndef GATE_H
 #define GATE_H
 
+#include <algorithm>
+#include <deque>
 #include <memory>
 #include <vector>
 #include <unordered_set>
 
+#include "arena.hpp"
+#include "builtin/registry.hpp"
+#include "bus.hpp"
 #include "common.hpp"
 #include "pin.hpp"
+#include "truth_table.hpp"
 #include "utils.hpp"
+#include "wire.hpp"
 #include "wire_info.hpp"
 
 /**
@@ -47,10 +54,12 @@ enum class GateType
   ROM_32K,
   REGISTER,
   MUX_16,
-  CUSTOM
+  CUSTOM,
+  BUILTIN
 };
 
 class Board;
+struct Netlist;
 
 
 /**
@@ -64,14 +73,27 @@ struct Gate
    * Gate information.
    */
   GateType                                     type;
+
+  /**
+   * Index into the BuiltinRegistry if this gate is (or is instantiated as) a builtin.
+   */
+  BuiltinOpcode                                opcode{ NO_BUILTIN };
   std::size_t                                  subgate_count{};
   std::string                                  name{};
   WireConstructionInfo                         wire_construction_recipe{};
   std::size_t                                  pin_count{};
-  std::vector<std::unique_ptr<Gate>>           subgates{};
+  ArenaVector<std::unique_ptr<Gate>>           subgates{};
+
+  /**
+   * Running totals of the subgates' pin counts, the input pins of subgates[i]
+   * are numbered from input_pins.size() + input_offsets[i] (likewise for outputs,
+   * past INPUT_PIN_LIMIT). Kept up to date by add_subgate.
+   */
+  ArenaVector<std::size_t>                     input_offsets{ 0 };
+  ArenaVector<std::size_t>                     output_offsets{ 0 };
   bool                                         serialized{};
-  std::vector<std::size_t>                     serialized_computation{};
-  std::vector<std::size_t>*                    serialized_computation_ptr{ nullptr };
+  TruthTable                                   serialized_computation{};
+  const TruthTable*                            serialized_computation_ptr{ nullptr };
 
   /**
    * Input/Output ports and wires.
@@ -84,10 +106,17 @@ struct Gate
    * like wire_construction_recipe. There is no point for every single chip to be holding
    * the same information
    */
-  std::vector<Pin>                             input_pins{};
-  std::vector<Pin>                             output_pins{};
-  std::vector<Wire*> wires;
-  
+  ArenaVector<Pin>                             input_pins{};
+  ArenaVector<Pin>                             output_pins{};
+
+  /**
+   * The gate owns all of the wires it connects. A deque never moves its elements,
+   * so the pins can refer to the wires directly.
+   *
+   * Gates and their containers are allocated from the active GateArena, if any.
+   */
+  ArenaDeque<Wire>                             wires{};
+
 
   explicit Gate(std::size_t ipc = 0,
                 std::size_t opc = 0,
@@ -103,6 +132,16 @@ struct Gate
   {
   }
 
+  static auto operator new(std::size_t size) -> void*
+  {
+    return GateArena::allocate_object(size);
+  }
+
+  static auto operator delete(void* gate) -> void
+  {
+    GateArena::deallocate_object(gate);
+  }
+
   auto print_truth_table() -> void
   {
     if (!serialized)
@@ -135,7 +174,7 @@ struct Gate
     // Loop through all perms.
     for (std::size_t i = 0; i < indicies; i++)
     {
-      auto output = (*serialized_computation_ptr).at(i);
+      auto output = serialized_computation_ptr->get(i);
 
       for (std::size_t j = 0; j < input_pins.size(); j++)
       {
@@ -159,6 +198,9 @@ struct Gate
   auto set_name(std::string_view new_name) -> void
   {
     name = new_name;
+
+    // A chip named like a builtin is always instantiated as that builtin.
+    opcode = BuiltinRegistry::instance().find(name);
   }
   
   const std::string& get_name() const
@@ -166,20 +208,41 @@ struct Gate
     return name;
   }
 
-  auto serialize() -> void
-  {
-    uint64_t indicies = (2ULL << (static_cast<uint64_t>(input_pins.size()) - 1));
+  /**
+   * Precompute the truth table of the gate. The rows are split across the
+   * shared thread pool whenever the gate is combinational. Returns false
+   * (and leaves the gate as is) if the gate has more than 'input_limit' inputs
+   * or more outputs than a table row can hold.
+   */
+  bool serialize(std::size_t input_limit = SERIALIZE_INPUT_LIMIT);
 
-    for (uint64_t i = 0; i < indicies; i++)
-    {
-      apply_input(input_pins.size(), static_cast<std::size_t>(i));
-      simulate();
-      serialized_computation.push_back(serialize_output());
-    }
-    this->serialized = true;
-    this->serialized_computation_ptr = &this->serialized_computation;
+  /**
+   * Use the given table as the truth table of the gate.
+   */
+  void use_table(TruthTable table)
+  {
+    serialized_computation = std::move(table);
+    serialized = true;
+    serialized_computation_ptr = &serialized_computation;
   }
 
+  /**
+   * Fill rows [first, last) of 'table' with a bit-parallel circuit
+   * (64 to 512 rows per pass), for netlists ParallelCircuit supports.
+   */
+  void serialize_parallel(std::shared_ptr<const Netlist> netlist, TruthTable& table, uint64_t first, uint64_t last);
+
+  /**
+   * Fill rows [first, last) of 'table' by stepping a compiled circuit of 'gate'.
+   */
+  void serialize_stepped(Gate& gate, std::shared_ptr<const Netlist> netlist, TruthTable& table, uint64_t first, uint64_t last);
+
+  /**
+   * Estimate of the bytes held by this gate and all of its subgates
+   * (pins, connections, wires and truth tables), shared tables excluded.
+   */
+  std::size_t memory_usage() const;
+
   inline auto serialize_output() -> std::size_t
   {
     return pinvec_to_uint(output_pins, 0, output_pins.size());
@@ -196,7 +259,7 @@ struct Gate
     auto serialized_input = serialize_input();
 
     // Retrieve the serialized output entry using the serialized input.
-    auto serialized_output = (*serialized_computation_ptr)[serialized_input];
+    auto serialized_output = serialized_computation_ptr->get(serialized_input);
 
     apply_output(static_cast<int>(output_pins.size()), serialized_output);
   }
@@ -287,57 +350,47 @@ struct Gate
   {
     if (INPUT_PIN_LIMIT > pin)
     {
-      std::size_t range = input_pins.size();
-
-      if ( range > pin )
+      if ( input_pins.size() > pin )
       {
         return &input_pins[pin];
       }
-      else
-      {
-        for (auto& subgate : subgates)
-        {
-          auto s = subgate->input_pins.size();
-          range += s;
-          if ( range > pin )
-          {
-            range -= s;
-            return &subgate->input_pins.at(pin - range);
-          }
-        }
-      }
+
+      return find_subgate_pin(pin - input_pins.size(), input_offsets, &Gate::input_pins);
     }
     else
     {
       pin -= INPUT_PIN_LIMIT;
 
-      std::size_t range = output_pins.size();
-
-      if ( range > pin )
+      if ( output_pins.size() > pin )
       {
-        auto w = &output_pins[pin];
-        return w;
-      }
-      else
-      {
-        for (auto& subgate : subgates)
-        {
-          auto s = subgate->output_pins.size();
-          range += s;
-          if ( range > pin )
-          {
-            range -= s;
-            return &subgate->output_pins.at(pin - range);
-          }
-        }
+        return &output_pins[pin];
       }
+
+      return find_subgate_pin(pin - output_pins.size(), output_offsets, &Gate::output_pins);
     }
+  }
 
-    return nullptr;
+  /**
+   * Binary search the subgate which owns the given pin, 'pin' is counted
+   * from the first pin of the first subgate.
+   */
+  auto find_subgate_pin(std::size_t pin, const ArenaVector<std::size_t>& offsets, ArenaVector<Pin> Gate::* pins) -> Pin*
+  {
+    if ( pin >= offsets.back() )
+    {
+      return nullptr;
+    }
+
+    const auto index = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), pin) - offsets.begin()) - 1;
+    return &((*subgates[index]).*pins)[pin - offsets[index]];
   }
 
   auto clear_wires() -> void
   {
+    for (auto& wire : wires)
+    {
+      std::erase(wire.input->connections, &wire);
+    }
     wires.clear();
   }
 
@@ -398,8 +451,21 @@ struct Gate
   	return add_subgate(gate->name, board);
   }
 
+  /**
+   * Add a copy of the named component of the board, Board::instance() if none is given.
+   */
   std::size_t add_subgate(std::string_view gate_name, Board* board = nullptr);
 
+  /**
+   * Take ownership of an already built subgate.
+   */
+  auto attach_subgate(std::unique_ptr<Gate> subgate) -> std::size_t;
+
+  /**
+   * Copy the gate. Subgates are re-resolved by name from the given board, so the
+   * copy picks up the board's current definitions. Without a board the subgates
+   * of this gate are copied as they are.
+   */
   std::unique_ptr<Gate> duplicate(Board* board = nullptr);
 
   void handle_custom_type(std::unordered_set<Gate*> was_visited);
@@ -423,15 +489,11 @@ struct Gate
     }
   }
 
-  void handle_pc();
-
-  void handle_ram_16k();
-
-  void handle_rom_32k();
-
-  auto handle_mux_16() -> void;
-
-  auto handle_register() -> void;
+  /**
+   * Run the registered builtin (PC, RAM, ROM, Mux16, Register, ...) through
+   * its evaluator, see BuiltinRegistry.
+   */
+  auto handle_builtin() -> void;
 
   auto input_info() -> void
   {
@@ -0,0 +1,267 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+
+#include "common.hpp"
+#include "content_hash.hpp"
+#include "gate_binary.hpp"
+
+namespace
+{
+
+constexpr char BINARY_MAGIC[8] = { 'G', 'A', 'T', 'E', 'B', 'I', 'N', '1' };
+
+constexpr std::uint32_t PRECOMPUTE_FLAG{ 1 };
+
+/**
+ * What a binary file remembers of the text file it was made from.
+ */
+struct SourceStamp
+{
+  std::uint64_t size;
+  std::int64_t  time;
+};
+
+auto stamp_of(const std::string& path) -> std::optional<SourceStamp>
+{
+  std::error_code ec{};
+  const auto size = std::filesystem::file_size(path, ec);
+  if (ec) return {};
+
+  const auto time = std::filesystem::last_write_time(path, ec);
+  if (ec) return {};
+
+  return SourceStamp{ size, static_cast<std::int64_t>(time.time_since_epoch().count()) };
+}
+
+auto hash_of(const std::string& path) -> std::uint64_t
+{
+  std::ifstream file{ path, std::ios::binary };
+  const std::string content{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+  return ContentHash().add(content).value();
+}
+
+} /* namespace */
+
+GateBinary::GateBinary(std::shared_ptr<const MappedFile> file)
+  : file{ std::move(file) }
+{
+}
+
+auto GateBinary::path(const std::string& gate_path) -> std::string
+{
+  return std::filesystem::path(gate_path).replace_extension(GATE_BINARY_EXTENSION).string();
+}
+
+auto GateBinary::open(const std::string& gate_path) -> std::optional<GateBinary>
+{
+  auto file = MappedFile::open(path(gate_path));
+  if (file == nullptr || file->size() < sizeof(Header))
+  {
+    return {};
+  }
+
+  // The header keeps everything behind it aligned within the (page aligned) mapping.
+  const auto& header = *reinterpret_cast<const Header*>(file->data());
+  const auto ref_count = std::size_t{ header.need_count } + header.subgate_count;
+  const auto expected = sizeof(Header)
+                      + ref_count * sizeof(StringRef)
+                      + std::size_t{ header.wire_count } * 2 * sizeof(std::uint32_t)
+                      + header.string_bytes;
+
+  if (std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0 || file->size() != expected)
+  {
+    return {};
+  }
+
+  const auto in_bounds = [&](const StringRef& ref) { return std::size_t{ ref.offset } + ref.length <= header.string_bytes; };
+  const auto* refs = reinterpret_cast<const StringRef*>(file->data() + sizeof(Header));
+  if (!in_bounds(header.name) || !std::all_of(refs, refs + ref_count, in_bounds))
+  {
+    return {};
+  }
+
+  // Only hash the text if it was touched since, it may have been rewritten with the same content.
+  const auto stamp = stamp_of(gate_path);
+  if (!stamp.has_value() || stamp->size != header.source_size)
+  {
+    return {};
+  }
+
+  if (stamp->time != header.source_time && hash_of(gate_path) != header.source_hash)
+  {
+    return {};
+  }
+
+  return GateBinary{ std::move(file) };
+}
+
+auto GateBinary::save(const std::string& gate_path, const GateDefinition& definition) -> bool
+{
+  const auto stamp = stamp_of(gate_path);
+  if (!stamp.has_value())
+  {
+    return false;
+  }
+
+  // Every name is stored once, subgates mostly repeat the same few chips.
+  std::string strings{};
+  std::map<std::string, StringRef, std::less<>> known{};
+  const auto intern = [&](const std::string& value)
+  {
+    auto [entry, inserted] = known.try_emplace(value, StringRef{ static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(value.size()) });
+    if (inserted) strings += value;
+    return entry->second;
+  };
+
+  Header header{};
+  std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  header.source_size = stamp->size;
+  header.source_time = stamp->time;
+  header.source_hash = hash_of(gate_path);
+  header.name = intern(definition.name);
+  header.input_count = static_cast<std::uint32_t>(definition.inputs);
+  header.output_count = static_cast<std::uint32_t>(definition.outputs);
+  header.need_count = static_cast<std::uint32_t>(definition.needs.size());
+  header.subgate_count = static_cast<std::uint32_t>(definition.subgates.size());
+  header.wire_count = static_cast<std::uint32_t>(definition.wires.size());
+  header.flags = definition.precompute ? PRECOMPUTE_FLAG : 0;
+
+  std::vector<StringRef> refs{};
+  refs.reserve(definition.needs.size() + definition.subgates.size());
+  for (const auto& need : definition.needs) refs.push_back(intern(need));
+  for (const auto& subgate : definition.subgates) refs.push_back(intern(subgate));
+
+  std::vector<std::uint32_t> wires{};
+  wires.reserve(definition.wires.size() * 2);
+  for (const auto& [src, dest] : definition.wires)
+  {
+    wires.push_back(static_cast<std::uint32_t>(src));
+    wires.push_back(static_cast<std::uint32_t>(dest));
+  }
+
+  header.string_bytes = static_cast<std::uint32_t>(strings.size());
+
+  const auto target = path(gate_path);
+  // Boards loading in parallel may save the same file at once, each writes its own copy.
+  const auto temporary = temporary_file(target);
+
+  {
+    std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+      return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(refs.data()), refs.size() * sizeof(StringRef));
+    file.write(reinterpret_cast<const char*>(wires.data()), wires.size() * sizeof(std::uint32_t));
+    file.write(strings.data(), strings.size());
+
+    if (!file)
+    {
+      return false;
+    }
+  }
+
+  // Readers never see a partially written file.
+  std::error_code ec{};
+  std::filesystem::rename(temporary, target, ec);
+  return !ec;
+}
+
+auto GateBinary::header() const -> const Header&
+{
+  return *reinterpret_cast<const Header*>(file->data());
+}
+
+auto GateBinary::refs() const -> const StringRef*
+{
+  return reinterpret_cast<const StringRef*>(file->data() + sizeof(Header));
+}
+
+auto GateBinary::string(const StringRef& ref) const -> std::string_view
+{
+  const auto* strings = reinterpret_cast<const char*>(file->data() + file->size() - header().string_bytes);
+  return { strings + ref.offset, ref.length };
+}
+
+auto GateBinary::name() const -> std::string_view
+{
+  return string(header().name);
+}
+
+auto GateBinary::input_count() const -> std::size_t
+{
+  return header().input_count;
+}
+
+auto GateBinary::output_count() const -> std::size_t
+{
+  return header().output_count;
+}
+
+auto GateBinary::precompute() const -> bool
+{
+  return (header().flags & PRECOMPUTE_FLAG) != 0;
+}
+
+auto GateBinary::need_count() const -> std::size_t
+{
+  return header().need_count;
+}
+
+auto GateBinary::need(std::size_t index) const -> std::string_view
+{
+  return string(refs()[index]);
+}
+
+auto GateBinary::subgate_count() const -> std::size_t
+{
+  return header().subgate_count;
+}
+
+auto GateBinary::subgate(std::size_t index) const -> std::string_view
+{
+  return string(refs()[header().need_count + index]);
+}
+
+auto GateBinary::wires() const -> std::span<const std::uint32_t>
+{
+  const auto* data = reinterpret_cast<const std::uint32_t*>(file->data() + sizeof(Header) + (need_count() + subgate_count()) * sizeof(StringRef));
+  return { data, wire_count() * 2 };
+}
+
+auto GateBinary::wire_count() const -> std::size_t
+{
+  return header().wire_count;
+}
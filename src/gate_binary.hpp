@@ -0,0 +1,143 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef GATE_BINARY_H
+#define GATE_BINARY_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "wire_info.hpp"
+
+/**
+ * Everything a .gate file declares: the chips it needs, the gate it creates,
+ * its pin counts, subgates and wires, and whether it is precomputed.
+ */
+struct GateDefinition
+{
+  std::string              name{};
+  std::vector<std::string> needs{};
+  std::size_t              inputs{};
+  std::size_t              outputs{};
+  std::vector<std::string> subgates{};
+  WireConstructionInfo     wires{};
+  bool                     precompute{};
+};
+
+/**
+ * The binary form of a .gate file, saved next to it as '<name>.gateb' and
+ * memory mapped when it is loaded. Declarations are read straight from the
+ * mapping, nothing is parsed.
+ *
+ * The text file stays the source of truth. A binary file records the size,
+ * modification time and content hash of the text it was made from, and is
+ * ignored as soon as the text does not match anymore.
+ */
+class GateBinary
+{
+public:
+  /**
+   * Where the binary form of the given .gate file lives.
+   */
+  static auto path(const std::string& gate_path) -> std::string;
+
+  /**
+   * Map the binary form of the given .gate file, returns nothing if there
+   * is none or if it is out of date.
+   */
+  static auto open(const std::string& gate_path) -> std::optional<GateBinary>;
+
+  /**
+   * Save the definition as the binary form of the given .gate file, which must already be written.
+   */
+  static auto save(const std::string& gate_path, const GateDefinition& definition) -> bool;
+
+  auto name() const -> std::string_view;
+
+  auto input_count() const -> std::size_t;
+
+  auto output_count() const -> std::size_t;
+
+  auto precompute() const -> bool;
+
+  auto need_count() const -> std::size_t;
+
+  auto need(std::size_t index) const -> std::string_view;
+
+  auto subgate_count() const -> std::size_t;
+
+  auto subgate(std::size_t index) const -> std::string_view;
+
+  /**
+   * The wires as pairs of pins, 'wire_count() * 2' entries.
+   */
+  auto wires() const -> std::span<const std::uint32_t>;
+
+  auto wire_count() const -> std::size_t;
+
+private:
+  struct StringRef
+  {
+    std::uint32_t offset;
+    std::uint32_t length;
+  };
+
+  struct Header
+  {
+    char          magic[8];
+    std::uint64_t source_size;
+    std::int64_t  source_time;
+    std::uint64_t source_hash;
+    StringRef     name;
+    std::uint32_t input_count;
+    std::uint32_t output_count;
+    std::uint32_t need_count;
+    std::uint32_t subgate_count;
+    std::uint32_t wire_count;
+    std::uint32_t flags;
+    std::uint32_t string_bytes;
+    std::uint32_t reserved;
+  };
+
+  GateBinary(std::shared_ptr<const MappedFile> file);
+
+  auto header() const -> const Header&;
+
+  auto string(const StringRef& ref) const -> std::string_view;
+
+  auto refs() const -> const StringRef*;
+
+private:
+  std::shared_ptr<const MappedFile> file;
+};
+
+#endif /* GATE_BINARY_H */
@@ -0,0 +1,142 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef GATE_IMAGE_H
+#define GATE_IMAGE_H
+
+#include <memory>
+#include <vector>
+
+#include "gate.hpp"
+#include "netlist.hpp"
+
+class GateInstance;
+
+/**
+ * The immutable, shared part of a chip: a prototype of its gate tree (pin
+ * layout, wiring, truth tables) and the netlist compiled from it.
+ *
+ * Any number of GateInstances can be made from one image, each of them only
+ * holds state: its top level pins, net values and copies of the builtins.
+ */
+class GateImage : public std::enable_shared_from_this<GateImage>
+{
+public:
+  static auto create(Gate& component, Board* board = nullptr) -> std::shared_ptr<const GateImage>
+  {
+    auto image = std::shared_ptr<GateImage>(new GateImage());
+    image->prototype = component.duplicate(board);
+    image->netlist = Netlist::compile(*image->prototype);
+    return image;
+  }
+
+  auto instantiate() const -> std::unique_ptr<GateInstance>;
+
+  auto get_name() const -> const std::string&
+  {
+    return prototype->name;
+  }
+
+  auto get_netlist() const -> const std::shared_ptr<const Netlist>&
+  {
+    return netlist;
+  }
+
+  auto memory_usage() const -> std::size_t
+  {
+    return sizeof(*this) + prototype->memory_usage() + netlist->memory_usage();
+  }
+
+private:
+  GateImage() = default;
+
+private:
+  std::unique_ptr<Gate>          prototype{};
+  std::shared_ptr<const Netlist> netlist{};
+};
+
+/**
+ * A single simulatable copy of a GateImage.
+ */
+class GateInstance
+{
+public:
+  explicit GateInstance(std::shared_ptr<const GateImage> image)
+    : image{ std::move(image) }
+  {
+    const auto& netlist = this->image->get_netlist();
+
+    pins = std::make_unique<Gate>(netlist->input_nets.size(), netlist->output_nets.size(),
+                                  GateType::CUSTOM, this->image->get_name());
+
+    std::vector<std::unique_ptr<Gate>> builtins{};
+    for (auto* builtin : netlist->builtins)
+    {
+      builtins.push_back(builtin->duplicate());
+    }
+
+    circuit = std::make_unique<CompiledCircuit>(*pins, netlist, std::move(builtins));
+  }
+
+  /**
+   * The top level pins of the instance, they are what gets read and written
+   * when the circuit is stepped. The gate has no subgates.
+   */
+  auto gate() -> Gate&
+  {
+    return *pins;
+  }
+
+  auto get_circuit() -> CompiledCircuit&
+  {
+    return *circuit;
+  }
+
+  auto get_image() const -> const GateImage&
+  {
+    return *image;
+  }
+
+  /**
+   * Bytes held by this instance alone.
+   */
+  auto memory_usage() const -> std::size_t
+  {
+    return sizeof(*this) + pins->memory_usage() + circuit->memory_usage();
+  }
+
+private:
+  std::shared_ptr<const GateImage> image;
+  std::unique_ptr<Gate>            pins{};
+  std::unique_ptr<CompiledCircuit> circuit{};
+};
+
+inline auto GateImage::instantiate() const -> std::unique_ptr<GateInstance>
+{
+  return std::make_unique<GateInstance>(shared_from_this());
+}
+
+#endif /* GATE_IMAGE_H */
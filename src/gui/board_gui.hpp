@@ -305,7 +305,7 @@ std::pair<std::size_t, PinGui*> get_pin(const sf::Vector2f& pos)
     auto current_component_name = ctx->current_component_name;
 
     auto name_not_empty = !current_component_name.empty();
-    auto component_not_found = !Board::instance()->found(current_component_name);
+    auto component_not_found = !Board::instance()->known(current_component_name);
 
     // We will only be able to save when the name isn't empty
     // and the component isn't already pre-existing.
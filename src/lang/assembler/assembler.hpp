@@ -411,7 +411,7 @@ public:
   }
   else
   {
-   report_error("Invalid token: " + this->current.lexeme);
+   report_error("Invalid token: " + std::string(this->current.lexeme));
   }
 
   if (this->panic)
@@ -39,8 +39,8 @@ namespace cpp20trie
         struct FixedStringImpl
         {
             constexpr FixedStringImpl(const char (&str)[N]) noexcept { std::copy_n(str, N, val); }
-            constexpr auto empty() const noexcept -> const bool { return size() == 0; }
-            constexpr auto head() const noexcept -> const char { return val[0]; }
+            constexpr auto empty() const noexcept -> bool { return size() == 0; }
+            constexpr auto head() const noexcept -> char { return val[0]; }
             static constexpr auto size() noexcept -> std::size_t{ return N; };
             constexpr auto tail() const noexcept -> FixedStringImpl<((N != 1) ? N - 1 : 1)>
             {
@@ -103,7 +103,7 @@ namespace cpp20trie
         template <typename... Transitions>
         struct TrieNode : Transitions... {};
 
-        constexpr auto check_trie(TrieNode<> trie, std::string_view str, auto&& fne, auto&&... fns) 
+        constexpr auto check_trie(TrieNode<>, std::string_view, auto&& fne, auto&&...) 
         noexcept -> decltype(fne())
         {
             return fne();
@@ -111,7 +111,7 @@ namespace cpp20trie
 
         // This case is only true when we have exactly one transition.
         template <int Char, typename Next, typename = Specialize<(Char >= 0)>>
-        constexpr auto check_trie(TrieNode<Transition<Char, Next>> trie, std::string_view str, auto&& fne, auto&&... fns) 
+        constexpr auto check_trie(TrieNode<Transition<Char, Next>>, std::string_view str, auto&& fne, auto&&... fns) 
         noexcept -> decltype(fne())
         {
             return (!str.empty() && (str[0] == Char))
@@ -184,13 +184,13 @@ namespace cpp20trie
             if constexpr (!std::is_same_v<decltype(default_function()), void>)
             {
                 auto ret = default_function();
-                std::initializer_list<int>({ (index == std::get<Is>(std::move(chars)) ? (ret = func.template operator()<Is>()), 0 : 0)...} );
+                std::initializer_list<int>({ (index == static_cast<std::size_t>(std::get<Is>(std::move(chars))) ? (ret = func.template operator()<Is>()), 0 : 0)...} );
                 return ret;
             }
             else
             {
                 auto found = false;
-                std::initializer_list<int>({ (index == std::get<Is>(std::move(chars)) ? found=true, (func.template operator()<Is>()), 0 : 0)...} );
+                std::initializer_list<int>({ (index == static_cast<std::size_t>(std::get<Is>(std::move(chars))) ? found=true, (func.template operator()<Is>()), 0 : 0)...} );
                 if (!found) default_function();
             }
         }
@@ -220,18 +220,24 @@ namespace cpp20trie
             return {};
         }
 
-        // Casse for reaching the end of the string and
-        // there is no transition at the current position.
-        template <unsigned int Index, class String, typename... Prefixes, typename... Transitions, typename = Specialize<(String::empty() || sizeof...(Transitions) == 0)>>
+        // Case for reaching the end of the string, or for no
+        // transition at the current position having the character.
+        // The end of a string is always the first transition of its
+        // node (it is inserted before any prefix has been skipped),
+        // which is where check_trie looks for it.
+        template <unsigned int Index, class String, typename... Prefixes, typename... Transitions, typename = Specialize<(String::size() == 1 || sizeof...(Transitions) == 0)>>
         constexpr auto insert_sorted(nil, String&& str, TrieNode<Prefixes...>, Transitions...)
         noexcept -> TrieNode<Prefixes..., decltype(transition_add<Index>(nil(), std::move(str))), Transitions...>
         {
             return {};
         }
 
-        template <std::size_t Index, class String, typename... Prefixes, int Ch, typename Next, typename... Transitions, typename = Specialize<(Ch != String::head())>>
+        // The transition is for another character, skip it and keep
+        // looking, so that strings sharing a prefix share its node
+        // no matter in which order they were added.
+        template <std::size_t Index, class String, typename... Prefixes, int Ch, typename Next, typename... Transitions, typename = Specialize<(String::size() > 1 && Ch != String::head())>>
         constexpr auto insert_sorted(nil, String&& str, TrieNode<Prefixes...>, Transition<Ch, Next>, Transitions...)
-        noexcept -> TrieNode<Prefixes..., decltype(transition_add<Index>(nil(), std::move(str))), Transition<Ch, Next>, Transitions...>
+        noexcept -> decltype(insert_sorted<Index>(nil(), std::move(str), TrieNode<Prefixes..., Transition<Ch, Next>>(), Transitions()...))
         {
             return {};
         }
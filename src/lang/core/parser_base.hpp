@@ -136,7 +136,7 @@ class BaseParser
      */
     auto report_token_error(Token<TokenType> token) noexcept -> void
     {
-        auto message = "Unexpected token " + token.lexeme + '.';
+        auto message = "Unexpected token " + std::string(token.lexeme) + '.';
         report_error(message);
     }
 
@@ -151,7 +151,7 @@ class BaseParser
 
         this->panic = true;
 
-        std::cout << "ERROR [ (line:" << previous.line << ") " << message << " ]\n";
+        *output << "ERROR [ (line:" << previous.line << ") " << message << " ]\n";
 
         this->has_error = true;
     }
@@ -177,6 +177,11 @@ class BaseParser
 
     bool panic{false};
     bool has_error{false};
+
+    /**
+     * Where errors are reported.
+     */
+    std::ostream* output{ &std::cout };
 };
 
 #endif /* HDL_PARSER_BASE_H */
@@ -34,6 +34,7 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <string_view>
 
 #include "comptrie.hpp"
 #include "token.hpp"
@@ -105,16 +106,19 @@ struct SCANNER(TOKEN_CLASS_NAME)
 
     /**
      * Return the identifer type. This could return as
-     * one of the keyword types.
+     * one of the keyword types. The keywords are matched
+     * by a trie built at compile time, one character at
+     * a time, directly on the source buffer.
      */
-    [[nodiscard]] auto identifier_type() -> TOKEN_CLASS_NAME 
+    [[nodiscard]] auto identifier_type() const noexcept -> TOKEN_CLASS_NAME 
     {
-        const auto word = source_code.substr(start, current-start);
-        
-        #define KEYWORD_TOKEN(name, symbol) if(symbol==word) return TOKEN_CLASS_NAME::name;
-        #include TOKEN_DESCRIPTOR_FILE
+        const auto word = slice();
 
-        return TOKEN_CLASS_NAME::Identifier;
+        return MATCH(word)
+            return TOKEN_CLASS_NAME::Identifier;
+        #define KEYWORD_TOKEN(name, symbol) CASE(symbol) return TOKEN_CLASS_NAME::name;
+        #include TOKEN_DESCRIPTOR_FILE
+        ENDMATCH
     }
 
     auto scan_string() -> Token<TOKEN_CLASS_NAME>
@@ -279,19 +283,27 @@ struct SCANNER(TOKEN_CLASS_NAME)
         }
     }
 
+    /**
+     * View of the source code between start and current.
+     */
+    [[nodiscard]] auto slice() const noexcept -> std::string_view
+    {
+        return std::string_view(this->source_code).substr(start, current - start);
+    }
+
     /**
      * Create a token with the current string slice.
      */
     [[nodiscard]] Token<TOKEN_CLASS_NAME> make_token(const TOKEN_CLASS_NAME type) noexcept 
     {
-        const std::size_t length = current - start;
-        return Token(type, this->source_code.substr(start, length), this->line);
+        return Token(type, slice(), this->line);
     }
 
     /**
-     * Create an error token.
+     * Create an error token. The message has to outlive
+     * the token, only string literals are passed here.
      */
-    [[nodiscard]] Token<TOKEN_CLASS_NAME> error_token(const std::string& message) noexcept 
+    [[nodiscard]] Token<TOKEN_CLASS_NAME> error_token(std::string_view message) noexcept 
     {
         return Token(TOKEN_CLASS_NAME::Error, message, this->line);
     }
@@ -26,10 +26,15 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
-#include <string>
+#include <string_view>
 
 /**
  * A basic token. Used to classify text.
+ *
+ * The lexeme is a view into the source buffer of the scanner which produced
+ * the token (or into a string literal for error tokens), so a token must not
+ * outlive its scanner, nor be used after the scanner was given a new source.
+ * Copy the lexeme into a std::string to keep it around.
  */
 template<typename TokenType>
 struct Token
@@ -53,16 +58,16 @@ struct Token
      */
     [[nodiscard]] Token() noexcept
         : type{TokenType::EndOfFile}
-        , lexeme{"\0"}
+        , lexeme{}
     {
     }
 
     /**
      * MEMBERS.
      */
-    TokenType   type{};
-    std::string lexeme{};
-    std::size_t line{};
+    TokenType        type{};
+    std::string_view lexeme{};
+    std::size_t      line{};
 };
 
 
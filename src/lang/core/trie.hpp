@@ -26,7 +26,8 @@
 #ifndef TRIE_H
 #define TRIE_H
 
-#include <array>
+#include <algorithm>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -37,8 +38,21 @@
  */
 constexpr std::size_t ASCII_COUNT{256};
 
+/**
+ * An edge to a child node, identified by its index in the trie.
+ */
+struct TrieEdge
+{
+    unsigned char letter{};
+    std::uint32_t node{};
+};
+
 /**
  * A simple trie node.
+ *
+ * Nodes only store the edges which exist, sorted by letter. Most nodes
+ * have one or two children, a table of every ASCII_COUNT possible letters
+ * would mostly hold null pointers.
  */
 struct TrieNode
 {
@@ -48,45 +62,40 @@ struct TrieNode
     char letter{};
 
     /**
-     * All possible nodes you can travel
-     * down to from the current node.
+     * This denotes the the current node is a leaf.
      */
-    std::array<TrieNode*, ASCII_COUNT> children{};
+    bool end_of_word{};
 
     /**
-     * This denotes the the current node is a leaf.
+     * All nodes you can travel down to from the current node, sorted by letter.
      */
-    bool end_of_word{};
+    std::vector<TrieEdge> children{};
 
     /**
      * METHODS.
      */
 
     /**
-     * Returns a newly created trie node.
+     * Returns the position of the edge for the letter, or where it would be inserted.
      */
-    [[nodiscard]] static inline TrieNode* make(const char letter) noexcept
+    [[nodiscard]] auto lower_bound(unsigned char letter) const noexcept -> std::vector<TrieEdge>::const_iterator
     {
-        auto trie = new TrieNode{
-            .letter = letter,
-            .children =
-                {
-                    nullptr,
-                },
-            .end_of_word = false,
-        };
-
-        for (std::size_t i = 0; i < ASCII_COUNT; i++)
-        {
-          trie->children[i] = nullptr;
-        }
+        return std::lower_bound(children.begin(), children.end(), letter,
+            [](const TrieEdge& edge, unsigned char value) { return edge.letter < value; });
+    }
 
-        return trie;
+    /**
+     * Returns the index of the child for the letter, or 0 (the root, never a child) if there is none.
+     */
+    [[nodiscard]] auto child(unsigned char letter) const noexcept -> std::uint32_t
+    {
+        const auto edge = lower_bound(letter);
+        return (edge != children.end() && edge->letter == letter) ? edge->node : 0;
     }
 };
 
 /**
- * The Trie class holds one root TrieNode.
+ * The Trie class holds its nodes in one vector, the first one is the root.
  */
 class Trie
 {
@@ -95,7 +104,7 @@ class Trie
      * Create a new trie.
      */
     Trie() noexcept
-        : root{TrieNode::make('\0')}
+        : nodes(1)
     {
     }
 
@@ -103,7 +112,7 @@ class Trie
      * Create a new trie with one value.
      */
     Trie(const std::string& word) noexcept
-        : root{TrieNode::make('\0')}
+        : nodes(1)
     {
         insert(word);
     }
@@ -112,7 +121,7 @@ class Trie
      * Create a new trie with multiple value.
      */
     Trie(const std::vector<std::string> words) noexcept
-        : root{TrieNode::make('\0')}
+        : nodes(1)
     {
         for (const auto& word : words)
         {
@@ -121,75 +130,41 @@ class Trie
     }
 
     /**
-     * Delete the root node and all of it's children.
+     * Fuzzy search.
      */
-    ~Trie() noexcept
+    std::vector<std::string> fuzzy(const std::string& word) const noexcept
     {
-        if (this->root != nullptr)
-         clean_up(this->root);
-    }
+        const auto current = find(word);
 
-    /**
-     * Fuzzy search.
-     */
-    std::vector<std::string> fuzzy(const std::string& word) noexcept 
-    {
-        TrieNode* current = this->root;
-
-        for (auto i = 0; word[i] != '\0'; i++)
-        {
-            const char letter = word[i];
-            auto index = static_cast<unsigned int>(letter);
-
-            /**
-             * If the current character's branch does not exist, not found.
-             */
-            if (current->children[index] == nullptr)
-            {
-                return {};
-            }
-            current = current->children[index];
-        }
-
-        std::vector<std::string> found;
-
-        fuzzySearchHelper(current, word, found);
-
-        return found;
-    }
-
-    /**
-     * Helper function for fuzzy search.
-     */
-    void fuzzySearchHelper(TrieNode* node, std::string current_word, std::vector<std::string>& found) {
-        if (node->end_of_word) {
-            found.push_back(current_word);
-        }
-
-        for (std::size_t i = 0; i < ASCII_COUNT; i++)
-        {
-            if (node->children[i] != nullptr) {
-                char ch = static_cast<char>(i);
-                std::string new_word = current_word + ch;
-
-                // Recursive call for adjacent nodes
-                fuzzySearchHelper(node->children[i], new_word, found);
-            }
-        }
+        /**
+         * If the word is not a prefix of any entry, not found.
+         */
+        if (current == 0 && !word.empty())
+        {
+            return {};
+        }
+
+        std::vector<std::string> found;
+
+        fuzzySearchHelper(current, word, found);
+
+        return found;
     }
 
     /**
-     * Clean up tree.
+     * Helper function for fuzzy search.
      */
-    void clean_up(TrieNode* node) noexcept
+    void fuzzySearchHelper(std::uint32_t node, std::string current_word, std::vector<std::string>& found) const
     {
-        if (node == nullptr)
-            return;
-        for (std::size_t i = 0; i < ASCII_COUNT; i++)
+        if (nodes[node].end_of_word) {
+            found.push_back(current_word);
+        }
+
+        for (const auto& edge : nodes[node].children)
         {
-            clean_up(node->children[i]);
+            // Recursive call for adjacent nodes
+            fuzzySearchHelper(edge.node, current_word + static_cast<char>(edge.letter), found);
         }
-        delete node;
     }
 
     /**
@@ -197,53 +172,40 @@ class Trie
      */
     void insert(const std::string& word) noexcept
     {
-        TrieNode* current = this->root;
+        std::uint32_t current = 0;
 
-        for (auto i = 0; word[i] != '\0'; i++)
+        for (const char letter : word)
         {
-            const char letter = word[i];
-            auto       index  = static_cast<unsigned int>(letter);
+            const auto index = static_cast<unsigned char>(letter);
+            auto       next  = nodes[current].child(index);
 
             /**
              * If the current character's branch does not exist, create it.
              */
-            if (current->children[index] == nullptr)
+            if (next == 0)
             {
-                current->children[index] = TrieNode::make(letter);
+                next = static_cast<std::uint32_t>(nodes.size());
+                auto& children = nodes[current].children;
+                children.insert(nodes[current].lower_bound(index), TrieEdge{ index, next });
+                nodes.push_back(TrieNode{ .letter = letter });
             }
-            current = current->children[index];
+            current = next;
         }
 
         /**
          * By this point, we would have reached the end of the word.
          * Now we can just must this position as a leaf node.
          */
-        current->end_of_word = true;
+        nodes[current].end_of_word = true;
     }
 
     /**
      * Search for the given word. Returns true if found.
      */
-    [[nodiscard]] bool search(const std::string& word) noexcept
+    [[nodiscard]] bool search(const std::string& word) const noexcept
     {
-        TrieNode* current = this->root;
-
-        for (auto i = 0; word[i] != '\0'; i++)
-        {
-            const char letter = word[i];
-            auto       index  = static_cast<unsigned int>(letter);
-
-            /**
-             * If the current character's branch does not exist, not found.
-             */
-            if (current->children[index] == nullptr)
-            {
-                return false;
-            }
-            current = current->children[index];
-        }
-
-        return current->end_of_word;
+        const auto current = find(word);
+        return (current != 0 || word.empty()) && nodes[current].end_of_word;
     }
 
     /**
@@ -251,35 +213,56 @@ class Trie
      */
     [[nodiscard]] bool match(const std::string& expected_word, const std::string& word) const noexcept
     {
-        if (expected_word.length() != word.length())
-            return false;
+        return expected_word == word && search(word);
+    }
 
-        TrieNode* current = this->root;
+    /**
+     * Number of nodes, the root included.
+     */
+    [[nodiscard]] auto node_count() const noexcept -> std::size_t
+    {
+        return nodes.size();
+    }
 
-        for (auto i = 0; word[i] != '\0'; i++)
+    /**
+     * Bytes held by the trie.
+     */
+    [[nodiscard]] auto memory_usage() const noexcept -> std::size_t
+    {
+        std::size_t bytes = sizeof(*this) + nodes.capacity() * sizeof(TrieNode);
+        for (const auto& node : nodes)
         {
-            const char expected_letter = expected_word[i];
-            const char letter          = word[i];
-            if (expected_letter != letter)
-                return false;
+            bytes += node.children.capacity() * sizeof(TrieEdge);
+        }
+        return bytes;
+    }
 
-            auto index = static_cast<unsigned int>(letter);
+  private:
+    /**
+     * Walk down the word. Returns the node it ends on, or 0 if it
+     * leaves the trie (or is empty).
+     */
+    [[nodiscard]] auto find(std::string_view word) const noexcept -> std::uint32_t
+    {
+        std::uint32_t current = 0;
 
+        for (const char letter : word)
+        {
             /**
              * If the current character's branch does not exist, not found.
              */
-            if (current->children[index] == nullptr)
+            current = nodes[current].child(static_cast<unsigned char>(letter));
+            if (current == 0)
             {
-                return false;
+                return 0;
             }
-            current = current->children[index];
         }
 
-        return current->end_of_word;
+        return current;
     }
 
   private:
-    TrieNode* root;
+    std::vector<TrieNode> nodes;
 };
 
 #endif /* TRIE_H */
@@ -27,13 +27,16 @@
 #define HDL_META_H
 
 #include <memory>
+#include <functional>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #include "../../common.hpp"
+#include "../../utils.hpp"
 #include "../core/raw_parser.hpp"
 #include "recipe_builder.hpp"
 #include "../core/token.hpp"
@@ -62,21 +65,9 @@ struct Meta
 
     [[nodiscard]] auto get_pin(std::string_view name) const noexcept -> const std::optional<PinEntry>
     {
-        auto pin_name = std::string(name);
-        for (const auto& pin_entry : input_pins)
+        if (const auto entry = pin_index.find(name); entry != pin_index.end())
         {
-            if (trie.match(pin_entry.pin_name, pin_name))
-            {
-                return pin_entry;
-            }
-        }
-
-        for (const auto& pin_entry : output_pins)
-        {
-            if (trie.match(pin_entry.pin_name, pin_name))
-            {
-                return pin_entry;
-            }
+            return PinEntry{ entry->first, entry->second };
         }
 
         return {};
@@ -84,24 +75,27 @@ struct Meta
 
     [[nodiscard]] auto get_bus(std::string_view name) const noexcept -> const std::optional<BusEntry>
     {
-        auto bus_name = std::string(name);
-        for (const auto& bus_entry : bus)
+        if (const auto entry = bus_index.find(name); entry != bus_index.end())
         {
-            if (trie.match(bus_entry.bus_name, bus_name))
-            {
-                return bus_entry;
-            }
+            return bus[entry->second];
         }
 
         return {};
     }
 
+    /**
+     * True if the name is a pin or a bus of the chip.
+     */
+    [[nodiscard]] auto has_member(std::string_view name) const noexcept -> bool
+    {
+        return pin_index.contains(name) || bus_index.contains(name);
+    }
+
     [[nodiscard]] static inline auto get_meta(std::string_view component_name) -> std::unique_ptr<const Meta>;
 
     auto add_input_pin(std::string_view pin_name) -> void
     {
-        this->input_pins.emplace_back(std::string(pin_name), input_pins.size());
-        this->trie.insert(std::string(pin_name));
+        index_pin(this->input_pins.emplace_back(std::string(pin_name), input_pins.size()));
         this->input_count++;
     }
 
@@ -123,16 +117,14 @@ struct Meta
 
     auto add_output_pin(std::string_view pin_name) -> void
     {
-        this->output_pins.emplace_back(std::string(pin_name), MAX_INPUT_PINS + output_pins.size());
-        this->trie.insert(std::string(pin_name));
+        index_pin(this->output_pins.emplace_back(std::string(pin_name), MAX_INPUT_PINS + output_pins.size()));
         this->output_count++;
     }
 
     auto add_input_bus(std::string_view bus_name, std::size_t size)
     {
         int32_t s = static_cast<int32_t>(size);
-        this->trie.insert(std::string(bus_name));
-        this->bus.emplace_back(std::string(bus_name), this->input_count, size);
+        index_bus(this->bus.emplace_back(std::string(bus_name), this->input_count, size));
 
         while (s --> 0)
         {
@@ -145,8 +137,7 @@ struct Meta
     auto add_output_bus(std::string_view bus_name, std::size_t size) -> void
     {
         int32_t s = static_cast<int32_t>(size);
-        this->trie.insert(std::string(bus_name));
-        this->bus.emplace_back(std::string(bus_name), MAX_INPUT_PINS + this->output_count, size);
+        index_bus(this->bus.emplace_back(std::string(bus_name), MAX_INPUT_PINS + this->output_count, size));
 
         while (s --> 0)
         {
@@ -162,6 +153,22 @@ struct Meta
         this->trie.insert(std::string(name));
     }
 
+    /**
+     * Register a pin or bus which was just added to the entries.
+     * The first entry of a name wins, inputs are looked up before outputs.
+     */
+    auto index_pin(const PinEntry& entry) -> void
+    {
+        this->trie.insert(entry.pin_name);
+        this->pin_index.try_emplace(entry.pin_name, entry.pin_number);
+    }
+
+    auto index_bus(const BusEntry& entry) -> void
+    {
+        this->trie.insert(entry.bus_name);
+        this->bus_index.try_emplace(entry.bus_name, this->bus.size() - 1);
+    }
+
     std::string           name{};
     std::size_t           input_count{};
     std::size_t           output_count{};
@@ -170,6 +177,13 @@ struct Meta
 
     std::vector<BusEntry> bus{};
     Trie                  trie;
+
+    /**
+     * Name to pin number and name to index into 'bus',
+     * built while the entries are added.
+     */
+    NameIndex<std::size_t> pin_index{};
+    NameIndex<std::size_t> bus_index{};
 };
 
 [[nodiscard]] inline auto Meta::get_meta(std::string_view component_name) -> std::unique_ptr<const Meta>
@@ -258,32 +272,29 @@ struct Meta
 
         
         parser.consume_token(RawTokenType::Identifier, "Expected identifier.");
-        const auto prev = parser.get_previous().lexeme;
+        const std::string prev { parser.get_previous().lexeme };
 
         if (prev == "BUSES")
         {
-            parser.consume_token(RawTokenType::Number, "Expected BUSES count (number), found " + parser.get_current().lexeme);
-            const int bus_count = std::stoi(parser.get_previous().lexeme);
+            parser.consume_token(RawTokenType::Number, "Expected BUSES count (number), found " + std::string(parser.get_current().lexeme));
+            const int bus_count = std::stoi(std::string(parser.get_previous().lexeme));
 
             for (int i = 0; i < bus_count; i++)
             {
                 // Parse BUS name.
                 parser.consume_token(RawTokenType::Identifier, "Expected identifier.");
-                const auto bus_name = parser.get_previous().lexeme;
+                const std::string bus_name { parser.get_previous().lexeme };
 
                 // Parse BUS start.
                 parser.consume_token(RawTokenType::Number, "Expected number.");
-                const auto bus_start = std::stoi(parser.get_previous().lexeme);
+                const auto bus_start = std::stoi(std::string(parser.get_previous().lexeme));
 
                 // Parse BUS size.
                 parser.consume_token(RawTokenType::Number, "Expected number.");
-                const auto bus_size = std::stoi(parser.get_previous().lexeme);
-
-                // Add the bus name entry.
-                meta->trie.insert(bus_name);
+                const auto bus_size = std::stoi(std::string(parser.get_previous().lexeme));
 
                 // Add the bus entry.
-                meta->bus.emplace_back(bus_name, bus_start, bus_size);
+                meta->index_bus(meta->bus.emplace_back(bus_name, bus_start, bus_size));
             }
 
             // Move onto 'INPUTS'
@@ -293,52 +304,50 @@ struct Meta
         // Parse the the count of inputs.
         if (auto lexeme = parser.get_previous().lexeme; lexeme != "INPUTS")
         {
-            parser.report_custom_error("Expected 'INPUTS', found " + lexeme);
+            parser.report_custom_error("Expected 'INPUTS', found " + std::string(lexeme));
         }
 
-        parser.consume_token(RawTokenType::Number, "Expected INPUTS count (number), found " + parser.get_current().lexeme);
-        meta->input_count = std::stoi(parser.get_previous().lexeme);
+        parser.consume_token(RawTokenType::Number, "Expected INPUTS count (number), found " + std::string(parser.get_current().lexeme));
+        meta->input_count = std::stoi(std::string(parser.get_previous().lexeme));
         for (std::size_t i = 0; i < meta->input_count; i++)
         {
-            parser.consume_token(RawTokenType::Identifier, "Expected identifier, found '" + parser.get_current().lexeme + "'.");
-            auto lexeme = parser.get_previous().lexeme;
+            parser.consume_token(RawTokenType::Identifier, "Expected identifier, found '" + std::string(parser.get_current().lexeme) + "'.");
+            std::string lexeme { parser.get_previous().lexeme };
 
             if (parser.match_token(RawTokenType::LSqaure))
             {
-                parser.consume_token(RawTokenType::Number, "Expected number, found" + parser.get_current().lexeme);
-                auto count = parser.get_previous().lexeme;
-                parser.consume_token(RawTokenType::RSquare, "Expected ']', found " + parser.get_current().lexeme);              
+                parser.consume_token(RawTokenType::Number, "Expected number, found" + std::string(parser.get_current().lexeme));
+                std::string count { parser.get_previous().lexeme };
+                parser.consume_token(RawTokenType::RSquare, "Expected ']', found " + std::string(parser.get_current().lexeme));              
                 lexeme = lexeme + "[" + count + "]";
             }
 
-            meta->input_pins.emplace_back(lexeme, i);
-            meta->trie.insert(lexeme);
+            meta->index_pin(meta->input_pins.emplace_back(lexeme, i));
         }
 
         // Parse the the count of outputs.
         parser.consume_token(RawTokenType::Identifier, "Expected identifier.");
         if (auto lexeme = parser.get_previous().lexeme; lexeme != "OUTPUTS") 
         {
-                parser.report_custom_error("Expected 'outputS', found " + lexeme);
+                parser.report_custom_error("Expected 'outputS', found " + std::string(lexeme));
         }
 
-        parser.consume_token(RawTokenType::Number, "Expected outputs count (number), found " + parser.get_current().lexeme);
-        meta->output_count = std::stoi(parser.get_previous().lexeme);
+        parser.consume_token(RawTokenType::Number, "Expected outputs count (number), found " + std::string(parser.get_current().lexeme));
+        meta->output_count = std::stoi(std::string(parser.get_previous().lexeme));
         for (std::size_t i = 0; i < meta->output_count; i++)
         {
-            parser.consume_token(RawTokenType::Identifier, "Expected identifier, found '" + parser.get_current().lexeme + "'.");
-            auto lexeme = parser.get_previous().lexeme;
+            parser.consume_token(RawTokenType::Identifier, "Expected identifier, found '" + std::string(parser.get_current().lexeme) + "'.");
+            std::string lexeme { parser.get_previous().lexeme };
 
             if (parser.match_token(RawTokenType::LSqaure))
             {
-                parser.consume_token(RawTokenType::Number, "Expected number, found" + parser.get_current().lexeme);
-                auto count = parser.get_previous().lexeme;
-                parser.consume_token(RawTokenType::RSquare, "Expected ']', found " + parser.get_current().lexeme);              
+                parser.consume_token(RawTokenType::Number, "Expected number, found" + std::string(parser.get_current().lexeme));
+                std::string count { parser.get_previous().lexeme };
+                parser.consume_token(RawTokenType::RSquare, "Expected ']', found " + std::string(parser.get_current().lexeme));              
                 lexeme = lexeme + "[" + count + "]";
             }
 
-            meta->output_pins.emplace_back(lexeme, i + MAX_INPUT_PINS);
-            meta->trie.insert(lexeme);
+            meta->index_pin(meta->output_pins.emplace_back(lexeme, i + MAX_INPUT_PINS));
         }
 
         if (parser.get_error())
@@ -49,11 +49,12 @@ class HDLParser : public BaseParser<HDLTokenType>
 {
   public:
     /**
-     * Constructor with file path of HDL source code.
+     * Constructor with file path of HDL source code, errors are written to 'out'.
      */
-    [[nodiscard]] explicit HDLParser(const std::string& file_path)
+    [[nodiscard]] explicit HDLParser(const std::string& file_path, std::ostream& out = std::cout)
         : BaseParser<HDLTokenType>(file_path)
     {
+        output = &out;
     }
 
     /**
@@ -131,8 +132,8 @@ class HDLParser : public BaseParser<HDLTokenType>
         // Multiple inputs.
         if (match(HDLTokenType::LSqaure))
         {
-            consume(HDLTokenType::Number, "Expected number for input size, found '" + current.lexeme + "'.");
-            const int count = std::stoi(previous.lexeme);
+            consume(HDLTokenType::Number, "Expected number for input size, found '" + std::string(current.lexeme) + "'.");
+            const int count = std::stoi(std::string(previous.lexeme));
 
             // Add the bus meta information.
             builder.add_bus(input_name, input_pin_offset, count);
@@ -145,7 +146,7 @@ class HDLParser : public BaseParser<HDLTokenType>
                 pin_numbers[input_name_index] = input_pin_offset++;
             }
 
-            consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+            consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
 
             log("Added multiple input " + input_name + " with size " + std::to_string(count));
         }
@@ -157,14 +158,14 @@ class HDLParser : public BaseParser<HDLTokenType>
 
         while (match(HDLTokenType::Comma))
         {
-            consume(HDLTokenType::Identifier, "Expected identifier, found '" + current.lexeme + "'.");
+            consume(HDLTokenType::Identifier, "Expected identifier, found '" + std::string(current.lexeme) + "'.");
             const std::string input_name { previous.lexeme };
 
             // Multiple inputs.
             if (match(HDLTokenType::LSqaure))
             {
-                consume(HDLTokenType::Number, "Expected number for input size, found '" + current.lexeme + "'.");
-                const int count = std::stoi(previous.lexeme);
+                consume(HDLTokenType::Number, "Expected number for input size, found '" + std::string(current.lexeme) + "'.");
+                const int count = std::stoi(std::string(previous.lexeme));
 
                 // Add the bus meta information.
                 builder.add_bus(input_name, input_pin_offset, count);
@@ -177,7 +178,7 @@ class HDLParser : public BaseParser<HDLTokenType>
                     pin_numbers[input_name_index] = input_pin_offset++;
                 }
 
-                consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
 
                 log("Added multiple input " + input_name + " with size " + std::to_string(count));
             }
@@ -188,7 +189,7 @@ class HDLParser : public BaseParser<HDLTokenType>
             }
         }
         consume(HDLTokenType::Semicolon,
-                "Expected ';' at the end of an IN statement, found '" + current.lexeme + "'.");
+                "Expected ';' at the end of an IN statement, found '" + std::string(current.lexeme) + "'.");
 
         log("Finished parsing IN statement.");
     }
@@ -206,8 +207,8 @@ class HDLParser : public BaseParser<HDLTokenType>
         // Multiple outputs.
         if (match(HDLTokenType::LSqaure))
         {
-            consume(HDLTokenType::Number, "Expected number for output size, found '" + current.lexeme + "'.");
-            const int count = std::stoi(previous.lexeme);
+            consume(HDLTokenType::Number, "Expected number for output size, found '" + std::string(current.lexeme) + "'.");
+            const int count = std::stoi(std::string(previous.lexeme));
 
             // Add the bus meta information.
             builder.add_bus(output_name, MAX_INPUT_PINS + output_pin_offset, count);
@@ -220,27 +221,28 @@ class HDLParser : public BaseParser<HDLTokenType>
                 pin_numbers[output_name_index] = MAX_INPUT_PINS + output_pin_offset++;
             }
 
-            consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+            consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
 
             log("Added multiple output " + output_name + " with size " + std::to_string(count));
         }
         else // Single input.
         {
-            builder.add_output_pin(previous.lexeme);
-            pin_numbers[previous.lexeme] = MAX_INPUT_PINS + output_pin_offset++;
+            const std::string output_name { previous.lexeme };
+            builder.add_output_pin(output_name);
+            pin_numbers[output_name] = MAX_INPUT_PINS + output_pin_offset++;
         }
 
         while (match(HDLTokenType::Comma))
         {
-            consume(HDLTokenType::Identifier, "Expected identifier, found '" + current.lexeme + "'.");
+            consume(HDLTokenType::Identifier, "Expected identifier, found '" + std::string(current.lexeme) + "'.");
 
             const std::string output_name { previous.lexeme };
 
             // Multiple outputs.
             if (match(HDLTokenType::LSqaure))
             {
-                consume(HDLTokenType::Number, "Expected number for output size, found '" + current.lexeme + "'.");
-                const int count = std::stoi(previous.lexeme);
+                consume(HDLTokenType::Number, "Expected number for output size, found '" + std::string(current.lexeme) + "'.");
+                const int count = std::stoi(std::string(previous.lexeme));
 
                 // Add the bus meta information.
                 builder.add_bus(output_name, MAX_INPUT_PINS + output_pin_offset, count);
@@ -253,19 +255,20 @@ class HDLParser : public BaseParser<HDLTokenType>
                     pin_numbers[output_name_index] = MAX_INPUT_PINS + output_pin_offset++;
                 }
 
-                consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
 
                 log("Added multiple output " + output_name + " with size " + std::to_string(count));
             }
             else // Single input.
             {
-                builder.add_output_pin(previous.lexeme);
-                pin_numbers[previous.lexeme] = MAX_INPUT_PINS + output_pin_offset++;
+                const std::string output_name { previous.lexeme };
+                builder.add_output_pin(output_name);
+                pin_numbers[output_name] = MAX_INPUT_PINS + output_pin_offset++;
             }
 
         }
         consume(HDLTokenType::Semicolon,
-                "Expected ';' at the end of an OUT statement, found '" + current.lexeme + "'.");
+                "Expected ';' at the end of an OUT statement, found '" + std::string(current.lexeme) + "'.");
 
         log("Finished parsing OUT statement.");
 
@@ -273,47 +276,47 @@ class HDLParser : public BaseParser<HDLTokenType>
 
     auto SUBGATE_statement() noexcept -> void
     {
-        log("Parsing identifier: " + previous.lexeme + ".");
-        auto subgate_name = previous.lexeme;
+        log("Parsing identifier: " + std::string(previous.lexeme) + ".");
+        std::string subgate_name { previous.lexeme };
         builder.add_dependency(subgate_name);
         auto subgate_added = add_subgate_metadata(subgate_name);
         if (!subgate_added)
         {
-            report_error("Could not retrieve metadata for '" + previous.lexeme + "'.");
+            report_error("Could not retrieve metadata for '" + std::string(previous.lexeme) + "'.");
         }
         else
         {
-            log("Getting context for " + previous.lexeme + " gate.");
-            this->context_gate_metadata = subgate_metadata.at(previous.lexeme).get();
+            log("Getting context for " + std::string(previous.lexeme) + " gate.");
+            this->context_gate_metadata = subgate_metadata.at(subgate_name).get();
         }
 
 
-        log("Parsing identifier: " + previous.lexeme + ".");
+        log("Parsing identifier: " + std::string(previous.lexeme) + ".");
 
         // Parsing the parameters of the subgate.
-        consume(HDLTokenType::LParen, "Expected left parenthesis, found '" + current.lexeme + "'.");
+        consume(HDLTokenType::LParen, "Expected left parenthesis, found '" + std::string(current.lexeme) + "'.");
 
         // We expect ATLEAST one linkage.
         consume(HDLTokenType::Identifier, "Linkage statement expects atleast one identifier.");
 
-        auto subgate_input_pin = previous.lexeme;
+        std::string subgate_input_pin { previous.lexeme };
 
         if (match(HDLTokenType::LSqaure))
         {
-            consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-            subgate_input_pin = subgate_input_pin + "[" + previous.lexeme + "]";
-            consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+            consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+            subgate_input_pin = subgate_input_pin + "[" + std::string(previous.lexeme) + "]";
+            consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
         }
 
-        consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + current.lexeme + "'.");
-        consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + current.lexeme + "'.");
-        auto subgate_output_name = previous.lexeme;
+        consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + std::string(current.lexeme) + "'.");
+        consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + std::string(current.lexeme) + "'.");
+        std::string subgate_output_name { previous.lexeme };
 
         if (match(HDLTokenType::LSqaure))
         {
-            consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-            subgate_output_name = subgate_output_name + "[" + previous.lexeme + "]";
-            consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+            consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+            subgate_output_name = subgate_output_name + "[" + std::string(previous.lexeme) + "]";
+            consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
         }
 
         if (subgate_added)
@@ -380,24 +383,24 @@ class HDLParser : public BaseParser<HDLTokenType>
         {
             consume(HDLTokenType::Identifier, "Linkage statement expects atleast one identifier.");
 
-            auto subgate_input_pin = previous.lexeme;
+            std::string subgate_input_pin { previous.lexeme };
 
             if (match(HDLTokenType::LSqaure))
             {
-                consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-                subgate_input_pin = subgate_input_pin + "[" + previous.lexeme + "]";
-                consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+                subgate_input_pin = subgate_input_pin + "[" + std::string(previous.lexeme) + "]";
+                consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
             }
 
-            consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + current.lexeme + "'.");
-            consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + current.lexeme + "'.");
-            auto subgate_output_name = previous.lexeme;
+            consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + std::string(current.lexeme) + "'.");
+            consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + std::string(current.lexeme) + "'.");
+            std::string subgate_output_name { previous.lexeme };
 
             if (match(HDLTokenType::LSqaure))
             {
-                consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-                subgate_output_name = subgate_output_name + "[" + previous.lexeme + "]";
-                consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+                subgate_output_name = subgate_output_name + "[" + std::string(previous.lexeme) + "]";
+                consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
             }
 
             if (subgate_added)
@@ -463,13 +466,16 @@ class HDLParser : public BaseParser<HDLTokenType>
             }
         }
 
-        consume(HDLTokenType::RParen, "Expected closing parenthesis, found '" + current.lexeme + "'.");
+        consume(HDLTokenType::RParen, "Expected closing parenthesis, found '" + std::string(current.lexeme) + "'.");
         consume(HDLTokenType::Semicolon,
-                "Expected ';' at the end of an PARTS statement, found '" + current.lexeme + "'.");
+                "Expected ';' at the end of an PARTS statement, found '" + std::string(current.lexeme) + "'.");
 
-        // Increment the offset accordingly.
-        input_pin_offset += context_gate_metadata->input_count;
-        output_pin_offset += context_gate_metadata->output_count;
+        // Increment the offset accordingly, a part without metadata was already reported.
+        if (subgate_added)
+        {
+            input_pin_offset += context_gate_metadata->input_count;
+            output_pin_offset += context_gate_metadata->output_count;
+        }
     }
 
     /**
@@ -479,51 +485,51 @@ class HDLParser : public BaseParser<HDLTokenType>
     {
         log("Parsing PARTS statement.");
 
-        consume(HDLTokenType::Colon, "Expected ':', found '" + current.lexeme + "'.");
+        consume(HDLTokenType::Colon, "Expected ':', found '" + std::string(current.lexeme) + "'.");
 
         // Subcomponents are NOT optional. A gate without subgates would be useless.
         // We expect atleast one identifier.
         consume(HDLTokenType::Identifier, "PARTS statement expects atleast one identifier.");
-        auto subgate_name = previous.lexeme;
+        std::string subgate_name { previous.lexeme };
         builder.add_dependency(subgate_name);
-        auto subgate_added = add_subgate_metadata(previous.lexeme);
+        auto subgate_added = add_subgate_metadata(subgate_name);
 
         if (!subgate_added)
         {
-            report_error("Could not retrieve metadata for '" + previous.lexeme + "'.");
+            report_error("Could not retrieve metadata for '" + std::string(previous.lexeme) + "'.");
         }
         else
         {
-            this->context_gate_metadata = subgate_metadata.at(previous.lexeme).get();
+            this->context_gate_metadata = subgate_metadata.at(subgate_name).get();
         }
 
-        log("Parsing identifier: " + previous.lexeme + ".");
+        log("Parsing identifier: " + std::string(previous.lexeme) + ".");
 
         // Parsing the parameters of the subgate.
-        consume(HDLTokenType::LParen, "Expected left parenthesis, found '" + current.lexeme + "'.");
+        consume(HDLTokenType::LParen, "Expected left parenthesis, found '" + std::string(current.lexeme) + "'.");
 
         // We expect ATLEAST one linkage.
         consume(HDLTokenType::Identifier, "Linkage statement expects atleast one identifier.");
 
-        auto subgate_input_pin = previous.lexeme;
+        std::string subgate_input_pin { previous.lexeme };
 
         if (match(HDLTokenType::LSqaure))
         {
-            consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-            subgate_input_pin = subgate_input_pin + "[" + previous.lexeme + "]";
-            consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+            consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+            subgate_input_pin = subgate_input_pin + "[" + std::string(previous.lexeme) + "]";
+            consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
         }
 
-        consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + current.lexeme + "'.");
+        consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + std::string(current.lexeme) + "'.");
 
-        consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + current.lexeme + "'.");
-        auto subgate_output_name = previous.lexeme;
+        consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + std::string(current.lexeme) + "'.");
+        std::string subgate_output_name { previous.lexeme };
 
         if (match(HDLTokenType::LSqaure))
         {
-            consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-            subgate_output_name = subgate_output_name + "[" + previous.lexeme + "]";
-            consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+            consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+            subgate_output_name = subgate_output_name + "[" + std::string(previous.lexeme) + "]";
+            consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
         }
 
         if (subgate_added)
@@ -592,24 +598,24 @@ class HDLParser : public BaseParser<HDLTokenType>
         {
             consume(HDLTokenType::Identifier, "Linkage statement expects atleast one identifier.");
 
-            auto subgate_input_pin = previous.lexeme;
+            std::string subgate_input_pin { previous.lexeme };
 
             if (match(HDLTokenType::LSqaure))
             {
-                consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-                subgate_input_pin = subgate_input_pin + "[" + previous.lexeme + "]";
-                consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+                subgate_input_pin = subgate_input_pin + "[" + std::string(previous.lexeme) + "]";
+                consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
             }
 
-            consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + current.lexeme + "'.");
-            consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + current.lexeme + "'.");
-            auto subgate_output_name = previous.lexeme;
+            consume(HDLTokenType::Assignment, "Expected assignment operator, found '" + std::string(current.lexeme) + "'.");
+            consume(HDLTokenType::Identifier, "Linkage statement expected output, found '" + std::string(current.lexeme) + "'.");
+            std::string subgate_output_name { previous.lexeme };
 
             if (match(HDLTokenType::LSqaure))
             {
-                consume(HDLTokenType::Number, "Expected number, found '" + current.lexeme + "'.");
-                subgate_output_name = subgate_output_name + "[" + previous.lexeme + "]";
-                consume(HDLTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(HDLTokenType::Number, "Expected number, found '" + std::string(current.lexeme) + "'.");
+                subgate_output_name = subgate_output_name + "[" + std::string(previous.lexeme) + "]";
+                consume(HDLTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
             }
 
             if (subgate_added)
@@ -675,12 +681,15 @@ class HDLParser : public BaseParser<HDLTokenType>
             }
         }
 
-        consume(HDLTokenType::RParen, "Expected closing parenthesis, found '" + current.lexeme + "'.");
-        consume(HDLTokenType::Semicolon, "Expected ';' at the end of an PARTS statement, found '" + current.lexeme + "'.");
+        consume(HDLTokenType::RParen, "Expected closing parenthesis, found '" + std::string(current.lexeme) + "'.");
+        consume(HDLTokenType::Semicolon, "Expected ';' at the end of an PARTS statement, found '" + std::string(current.lexeme) + "'.");
 
-        // Increment the offset accordingly.
-        input_pin_offset += context_gate_metadata->input_count;
-        output_pin_offset += context_gate_metadata->output_count;
+        // Increment the offset accordingly, a part without metadata was already reported.
+        if (subgate_added)
+        {
+            input_pin_offset += context_gate_metadata->input_count;
+            output_pin_offset += context_gate_metadata->output_count;
+        }
 
         while (match(HDLTokenType::Identifier))
         {
@@ -698,11 +707,11 @@ class HDLParser : public BaseParser<HDLTokenType>
         log("Parsing CHIP declaration.");
 
         // Parse the chip name.
-        consume(HDLTokenType::Identifier, "Expected CHIP name, found '" + current.lexeme + "'.");
-        builder.set_gate_name(previous.lexeme);
+        consume(HDLTokenType::Identifier, "Expected CHIP name, found '" + std::string(current.lexeme) + "'.");
+        builder.set_gate_name(std::string(previous.lexeme));
 
         // Beginning the definition.
-        consume(HDLTokenType::LBrace, "CHIP declaration expected definition block, missing '{', found '" + current.lexeme + "'.");
+        consume(HDLTokenType::LBrace, "CHIP declaration expected definition block, missing '{', found '" + std::string(current.lexeme) + "'.");
 
         while (!match(HDLTokenType::RBrace))
         {
@@ -720,7 +729,7 @@ class HDLParser : public BaseParser<HDLTokenType>
             }
             else if (match(HDLTokenType::EndOfFile))
             {
-                report_error("CHIP definition not terminated, expected '}', found '" + current.lexeme + "'.");
+                report_error("CHIP definition not terminated, expected '}', found '" + std::string(current.lexeme) + "'.");
                 return;
             }
         }
@@ -766,7 +775,7 @@ class HDLParser : public BaseParser<HDLTokenType>
 
         while (this->current.type != HDLTokenType::EndOfFile)
         {
-            auto token = "Token: " + current.lexeme + ", " + std::string(current.type.name());
+            auto token = "Token: " + std::string(current.lexeme) + ", " + std::string(current.type.name());
             log(token);
             if (this->previous.type == HDLTokenType::Semicolon)
                 return;
@@ -33,6 +33,7 @@
 #include <vector>
 #include <set>
 
+#include "../../gate_binary.hpp"
 #include "../../wire_info.hpp"
 #include "../../common.hpp"
 
@@ -122,6 +123,24 @@ class RecipeBuilder
         return ss.str();
     }
 
+    /**
+     * What compile() declares, for the binary form of the .gate file.
+     */
+    [[nodiscard]] auto definition() const noexcept -> GateDefinition
+    {
+        const std::set<std::string> unique_dependencies( dependencies.begin(), dependencies.end() );
+
+        GateDefinition result{};
+        result.name = name;
+        result.needs.assign(unique_dependencies.begin(), unique_dependencies.end());
+        result.inputs = input_pins.size();
+        result.outputs = output_pins.size();
+        result.subgates = dependencies;
+        result.wires = wire_linkages;
+        result.precompute = serializable;
+        return result;
+    }
+
     /**
      * Set gate name.
      */
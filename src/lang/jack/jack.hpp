@@ -179,7 +179,7 @@ public:
  {
   if (!current.type.is_keyword() && current.type != TokenType::Identifier) 
   {
-   report_error("Expected identifier, found: " + current.lexeme);
+   report_error("Expected identifier, found: " + std::string(current.lexeme));
   }
   advance();
 
@@ -207,7 +207,7 @@ public:
 
     if (entry == nullptr)
     {
-     report_error("'" + previous.lexeme + "' undefined");
+     report_error("'" + std::string(previous.lexeme) + "' undefined");
      return;
     }
 
@@ -249,7 +249,7 @@ public:
   else if (match(TokenType::Number))
   {
    write_previous();
-   m_writer.write_push("constant", previous.lexeme);
+   m_writer.write_push("constant", std::string(previous.lexeme));
   }
   // String
   else if (match(TokenType::String))
@@ -260,7 +260,7 @@ public:
   else if (match(TokenType::Identifier))
   {
    // Variable name
-   auto name = previous.lexeme;
+   std::string name { previous.lexeme };
    write_previous();
 
    if (match(TokenType::LSquare))
@@ -310,11 +310,11 @@ public:
    }
    else
    {
-    const auto entry = m_context.get_entry(previous.lexeme);
+    const auto entry = m_context.get_entry(std::string(previous.lexeme));
 
     if (entry == nullptr)
     {
-     report_error("'" + previous.lexeme + "' undefined");
+     report_error("'" + std::string(previous.lexeme) + "' undefined");
      return;
     }
 
@@ -691,7 +691,7 @@ public:
    m_writer.write_pop(segment, index);
   }
 
-  consume(TokenType::Semicolon, "Expected ';' at the end of let statement, found: " + current.lexeme);
+  consume(TokenType::Semicolon, "Expected ';' at the end of let statement, found: " + std::string(current.lexeme));
   write_previous();
  }
 
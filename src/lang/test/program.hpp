@@ -0,0 +1,124 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#ifndef TEST_PROGRAM_H
+#define TEST_PROGRAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace test
+{
+
+struct ChipInfo;
+
+enum class ConditionType
+{
+ IS,
+ NOT,     
+};
+
+/**
+ * Either a constant or a run of pins of a test variable. Members are resolved
+ * against the chip's meta data when the TEST is compiled, a pin is a bus of
+ * width 1. The pins are read MSB first, like buses.
+ */
+struct Operand
+{
+    enum class Kind : std::uint8_t
+    {
+        Constant,
+        Input,
+        Output
+    };
+
+    Kind          kind{ Kind::Constant };
+    bool          bus{ false };
+    std::uint16_t variable{ 0 };
+    std::uint32_t start{ 0 };
+    std::uint32_t width{ 0 };
+    std::size_t   value{ 0 };
+
+    /**
+     * The operand as it was written, for failure messages.
+     */
+    std::string   text{};
+};
+
+enum class TestOp : std::uint8_t
+{
+    VAR,
+    SET,
+    EVAL,
+    REQUIRE
+};
+
+/**
+ * - VAR:     Instantiate 'chip' into the variable slot 'variable'.
+ * - SET:     Write operands[b] into the input pins of operands[a].
+ * - EVAL:    Step every variable.
+ * - REQUIRE: Check conditions[a] up to conditions[a + b].
+ *
+ * 'line' is the source line reported by failures.
+ */
+struct TestInstruction
+{
+    TestOp        op;
+    std::uint16_t variable{ 0 };
+    std::uint32_t a{ 0 };
+    std::uint32_t b{ 0 };
+    std::size_t   line{ 0 };
+    ChipInfo*     chip{ nullptr };
+};
+
+struct CompiledCondition
+{
+    std::uint32_t a;
+    std::uint32_t b;
+    ConditionType type;
+};
+
+/**
+ * A TEST block compiled into straight line code over variable slots, so that
+ * running it does not look up any name.
+ */
+struct TestProgram
+{
+    std::vector<TestInstruction>   code{};
+    std::vector<Operand>           operands{};
+    std::vector<CompiledCondition> conditions{};
+
+    /**
+     * The name of every variable slot, and the slots in name order (the
+     * order in which the variables are stepped).
+     */
+    std::vector<std::string>       variables{};
+    std::vector<std::uint16_t>     step_order{};
+};
+
+} /* namespace test */
+
+#endif /* TEST_PROGRAM_H */
@@ -27,13 +27,17 @@
 #define TESTER_H
 
 #include <map>
+#include <optional>
 #include <string>
 #include <algorithm>
 
 #include "../../common.hpp"
 #include "../../board.hpp"
+#include "../../gate_image.hpp"
+#include "../../parallel_circuit.hpp"
 #include "../core/parser_base.hpp"
 #include "../hdl/meta.hpp"
+#include "program.hpp"
 #include "token_test.hpp"
 
 namespace test
@@ -51,13 +55,29 @@ struct ChipInfo
 {
   Gate*                            gate;  
   std::unique_ptr<const hdl::Meta> meta;
+  std::shared_ptr<const GateImage> image{};
 };
 
 struct Variable
 {
- ChipInfo*             chip_info;       
- Gate*                 chip;
- std::set<std::string> values;
+ ChipInfo*                        chip_info{ nullptr };
+ Gate*                            chip{ nullptr };
+ std::unique_ptr<GateInstance>    instance{};
+ Gate*                            reference{ nullptr };
+ std::unique_ptr<ParallelCircuit> batch{};
+
+ /**
+  * The gate tree the reference engine runs on (Reference and Differential modes).
+  */
+ std::unique_ptr<Gate>            tree{};
+
+ /**
+  * Batched mode only: the inputs recorded for every pending EVAL (one lane per EVAL),
+  * the results once they are evaluated and the lane of the last EVAL (-1 if none is pending).
+  */
+ std::vector<ParallelCircuit::Lanes> lane_inputs{};
+ std::vector<ParallelCircuit::Lanes> lane_outputs{};
+ int                                 lane{ -1 };
 };
 
 enum class ValueType
@@ -73,12 +93,6 @@ struct Value
     std::string member;
 };
 
-enum class ConditionType
-{
- IS,
- NOT,     
-};
-
 struct Condition
 {
     Value a;
@@ -86,6 +100,26 @@ struct Condition
     ConditionType type;  
 };
 
+/**
+ * The pins of a variable at the time a REQUIRE was deferred.
+ */
+struct PinSnapshot
+{
+    std::vector<PinState> inputs;
+    std::vector<PinState> outputs;
+    int                   lane;
+};
+
+/**
+ * A REQUIRE which waits for its batch of EVALs to be evaluated, with the pins
+ * of every declared variable (by slot) at the time it was reached.
+ */
+struct DeferredRequire
+{
+    TestInstruction                         require;
+    std::vector<std::optional<PinSnapshot>> snapshots;
+};
+
 /**
  * An interpreter for the test code.
  */
@@ -93,12 +127,15 @@ class Tester : public BaseParser<TestTokenType>
 {
   public:
     /**
-     * Constructor with file path of test source code.
+     * Constructor with file path of test source code. The chips are loaded
+     * into (and simulated with the settings of) the given board, the results
+     * are written to 'out'.
      */
-    [[nodiscard]] explicit Tester(const std::string& file_path)
+    [[nodiscard]] explicit Tester(const std::string& file_path, Board* board = Board::instance(), std::ostream& out = std::cout)
         : BaseParser<TestTokenType>(file_path)
+        , board_ptr{ board }
     {
-        board_ptr = Board::instance();
+        output = &out;
     }
 
     /**
@@ -121,6 +158,16 @@ class Tester : public BaseParser<TestTokenType>
         return !this->has_error;
     }
 
+    auto passed_count() const noexcept -> std::size_t
+    {
+        return passed_tests;
+    }
+
+    auto failed_count() const noexcept -> std::size_t
+    {
+        return failed_tests;
+    }
+
     /**
      * Parsing functions.
      */
@@ -131,6 +178,10 @@ class Tester : public BaseParser<TestTokenType>
         {
             LOAD_statement();
         }
+        else if (match(TestTokenType::Mode))
+        {
+            MODE_statement();
+        }
         else if (match(TestTokenType::Test))
         {
             TEST_statement();
@@ -177,7 +228,7 @@ class Tester : public BaseParser<TestTokenType>
         log("Parsing LOAD statement.");
 
         consume(TestTokenType::Identifier, "Expected chip name.");
-        const auto chip_name = previous.lexeme;
+        const std::string chip_name { previous.lexeme };
 
         log("Loading chip: " + chip_name);
 
@@ -190,6 +241,28 @@ class Tester : public BaseParser<TestTokenType>
         log("Finished parsing LOAD statement.");
     }
 
+    /**
+     * The variables declared after a MODE statement are simulated in that mode,
+     * whatever the board is set to.
+     */
+    auto MODE_statement() noexcept -> void
+    {
+        log("Parsing MODE statement.");
+
+        consume(TestTokenType::Identifier, "Expected simulation mode.");
+        const std::string name { previous.lexeme };
+
+        if (name == "reference")         file_mode = SimulationMode::Reference;
+        else if (name == "compiled")     file_mode = SimulationMode::Compiled;
+        else if (name == "differential") file_mode = SimulationMode::Differential;
+        else if (name == "batched")      file_mode = SimulationMode::Batched;
+        else report_error("Unknown simulation mode '" + name + "', expected 'reference', 'compiled', 'differential' or 'batched'.");
+
+        expect_semicolon("Expected ';' at the end of MODE statement.");
+
+        log("Finished parsing MODE statement.");
+    }
+
     auto parse_quote() noexcept -> std::string
     {
         std::stringstream val{};
@@ -216,71 +289,352 @@ class Tester : public BaseParser<TestTokenType>
         consume(TestTokenType::Semicolon, message);
     }
 
-    auto VAR_impl(const std::string& varname, const std::string& type) noexcept -> void
+    auto VAR_impl(const TestInstruction& instruction) noexcept -> void
     {
-        if (chip_images.count(type) == 0)
+        // A redeclared variable replaces its slot, its pending EVALs and REQUIREs go first.
+        if (variables[instruction.variable].chip != nullptr)
         {
-            report_error("Chip type '" + type + "' not found.");
-            return;
+            flush_batch();
         }
 
-        ChipInfo* image = &chip_images.at(type);
+        ChipInfo* image = instruction.chip;
 
-        std::set<std::string> values{};
-        auto add_value = [&](const auto& pin) { values.insert(pin.pin_name); };
+        const auto mode = file_mode.value_or(board_ptr->simulation_mode());
+        Gate* chip{ nullptr };
+        std::unique_ptr<GateInstance> instance{};
+        std::unique_ptr<ParallelCircuit> batch{};
+        std::unique_ptr<Gate> tree{};
+        Gate* reference{ nullptr };
 
-        std::for_each(image->meta->input_pins.begin(), 
-                      image->meta->input_pins.end(), 
-                      add_value);
+        // Everything a variable is made of goes away together at the end of the test.
+        GateArena::Scope scope{ *test_arena };
 
-        std::for_each(image->meta->output_pins.begin(), 
-                      image->meta->output_pins.end(), 
-                      add_value);
+        if (mode == SimulationMode::Reference)
+        {
+            tree = board_ptr->reference_copy(*image->gate);
+            chip = tree.get();
+        }
+        else
+        {
+            // Every variable of a type shares the same compiled image.
+            if (image->image == nullptr)
+            {
+                GateArena::Scope image_scope{ image_arena };
+                image->image = GateImage::create(*image->gate, board_ptr);
+            }
 
-        std::for_each(image->meta->bus.begin(), 
-                      image->meta->bus.end(), 
-                      [&](const auto& bus) { values.insert(bus.bus_name); });
+            // Only purely combinational chips can have their EVALs batched.
+            const auto& netlist = image->image->get_netlist();
+            if (mode == SimulationMode::Batched && ParallelCircuit::supports(*netlist))
+            {
+                batch = std::make_unique<ParallelCircuit>(netlist);
+            }
+
+            instance = image->image->instantiate();
+            chip = &instance->gate();
+        }
+
+        // The reference engine gets its own copy of the chip to run on.
+        if (mode == SimulationMode::Differential)
+        {
+            tree = board_ptr->reference_copy(*image->gate);
+            reference = tree.get();
+        }
 
-        const auto key = board_ptr->context().second->add_subgate(image->gate, board_ptr);
-        auto chip = board_ptr->context().second->subgates[key].get();
+        Variable variable{ image, chip, std::move(instance), reference, std::move(batch) };
+        variable.tree = std::move(tree);
+        if (variable.batch != nullptr)
+        {
+            variable.lane_inputs.assign(chip->input_pins.size(), 0);
+        }
 
-        variables[varname] = { image, chip, std::move(values) };
+        variables[instruction.variable] = std::move(variable);
     }
 
     auto VAR_statement() noexcept -> void
     {
         log("Parsing VAR statement.");
         consume(TestTokenType::Identifier, "Expected variable name.");
-        const auto varname = previous.lexeme;
+        const std::string varname { previous.lexeme };
 
         consume(TestTokenType::colon, "Expected ':' after variable name.");
 
         consume(TestTokenType::Identifier, "Expected variable type.");
-        const auto vartype = previous.lexeme;
+        const std::string vartype { previous.lexeme };
 
         log("Varname: " + varname);
         log("Type: " + vartype);
 
         expect_semicolon("Expected ';' at the end of VAR statement.");
 
-        VAR_impl(varname, vartype);
+        if (chip_images.count(vartype) == 0)
+        {
+            report_error("Chip type '" + vartype + "' not found.");
+            return;
+        }
+
+        // A redeclared variable replaces the old one in its slot, possibly with another type.
+        if (symbols.count(varname) == 0)
+        {
+            symbols[varname] = static_cast<std::uint16_t>(program.variables.size());
+            program.variables.push_back(varname);
+        }
+        else
+        {
+            members.clear();
+        }
+
+        const auto slot = symbols.at(varname);
+        slot_types.resize(program.variables.size(), nullptr);
+        slot_types[slot] = &chip_images.at(vartype);
+
+        program.code.push_back({ .op=TestOp::VAR, .variable=slot, .line=previous.line, .chip=slot_types[slot] });
         
         log("Finished parsing VAR statement.");
     }
 
-    auto EVAL_impl() noexcept -> void
+    auto EVAL_impl(const TestInstruction& instruction) noexcept -> void
     {
         log("RUNNING EVAL!!!");
-        for (auto& [_, variable] : variables)
+
+        if (lanes_used == ParallelCircuit::WORD_LANES)
+        {
+            flush_batch();
+        }
+
+        bool batched = false;
+        for (const auto slot : program.step_order)
+        {
+            auto& variable = variables[slot];
+            if (variable.chip == nullptr) continue;
+
+            if (variable.batch != nullptr)
+            {
+                record_lane(variable);
+                batched = true;
+                continue;
+            }
+
+            if (variable.instance == nullptr)
+            {
+                variable.chip->simulate();
+                continue;
+            }
+
+            if (variable.reference == nullptr)
+            {
+                step_compiled(program.variables[slot], variable, instruction.line);
+                continue;
+            }
+
+            // Builtins may touch their own input pins, so the inputs are handed over first.
+            for (std::size_t i = 0; i < variable.chip->input_pins.size(); i++)
+            {
+                variable.reference->input_pins[i].state = variable.chip->input_pins[i].state;
+            }
+
+            const auto settled = step_compiled(program.variables[slot], variable, instruction.line);
+            variable.reference->simulate();
+
+            // The outputs of a loop which did not settle depend on when each engine gave up.
+            if (settled)
+            {
+                compare_reference(program.variables[slot], variable, instruction.line);
+            }
+        }
+
+        if (batched)
+        {
+            lanes_used++;
+        }
+    }
+
+    /**
+     * Step the compiled circuit of a variable. Returns false, and notes it, if a
+     * feedback loop of the chip did not settle within the step.
+     */
+    auto step_compiled(const std::string& name, Variable& variable, std::size_t line) noexcept -> bool
+    {
+        auto& circuit = variable.instance->get_circuit();
+        const auto unsettled = circuit.get_activity().unsettled;
+
+        circuit.step();
+
+        if (circuit.get_activity().unsettled == unsettled)
+        {
+            return true;
+        }
+
+        std::stringstream ss;
+        ss << "[ Line " << std::to_string(line) << " ] EVAL " << name << " did not settle";
+        unsettled_messages.emplace_back(ss.str());
+        return false;
+    }
+
+    /**
+     * Make sure that the compiled and the reference engine agree.
+     */
+    auto compare_reference(const std::string& name, Variable& variable, std::size_t line) noexcept -> void
+    {
+        auto chip = variable.chip;
+        auto reference = variable.reference;
+
+        for (std::size_t i = 0; i < chip->output_pins.size(); i++)
+        {
+            const auto compiled = chip->output_pins[i].is_active() ? 1 : 0;
+            const auto expected = reference->output_pins[i].is_active() ? 1 : 0;
+
+            if (compiled != expected)
+            {
+                test_failed = true;
+
+                std::stringstream ss;
+                ss << "[ Line " << std::to_string(line) << " ] EVAL "
+                   << name << "." << variable.chip_info->meta->output_pins.at(i).pin_name
+                   << " -> "
+                   << "\033[1;31m"
+                   << "compiled " << compiled << ", reference " << expected
+                   << "\033[0m";
+
+                failed_messages.emplace_back(ss.str());
+                return;
+            }
+        }
+    }
+
+    /**
+     * Batched mode: record the current inputs of the variable into the next lane.
+     */
+    auto record_lane(Variable& variable) noexcept -> void
+    {
+        const auto& inputs = variable.chip->input_pins;
+        for (std::size_t i = 0; i < inputs.size(); i++)
+        {
+            if (inputs[i].is_active())
+            {
+                variable.lane_inputs[i] |= ParallelCircuit::Lanes{ 1 } << lanes_used;
+            }
+        }
+
+        variable.lane = static_cast<int>(lanes_used);
+    }
+
+    /**
+     * Write the outputs which the given lane computed into the chip's output pins.
+     */
+    auto apply_lane(Variable& variable, int lane) noexcept -> void
+    {
+        auto& outputs = variable.chip->output_pins;
+        for (std::size_t i = 0; i < outputs.size(); i++)
+        {
+            const auto active = (variable.lane_outputs[i] >> lane) & 1;
+            outputs[i].state = active ? PinState::ACTIVE : PinState::INACTIVE;
+        }
+    }
+
+    /**
+     * Batched mode: evaluate every pending EVAL in one pass per variable, then check the
+     * REQUIREs which were waiting on them against the pins they saw.
+     */
+    auto flush_batch() noexcept -> void
+    {
+        if (lanes_used == 0) return;
+
+        for (auto& variable : variables)
+        {
+            if (variable.batch == nullptr) continue;
+
+            for (std::size_t i = 0; i < variable.lane_inputs.size(); i++)
+            {
+                variable.batch->set_input(i, 0, variable.lane_inputs[i]);
+            }
+
+            variable.batch->evaluate();
+
+            variable.lane_outputs.resize(variable.chip->output_pins.size());
+            for (std::size_t i = 0; i < variable.lane_outputs.size(); i++)
+            {
+                variable.lane_outputs[i] = variable.batch->get_output(i, 0);
+            }
+        }
+
+        if (!deferred_requires.empty())
+        {
+            const auto current_pins = snapshot_all(false);
+
+            for (auto& deferred : deferred_requires)
+            {
+                restore_all(deferred.snapshots);
+                REQUIRE_impl(deferred.require);
+            }
+            deferred_requires.clear();
+
+            restore_all(current_pins);
+        }
+
+        for (auto& variable : variables)
+        {
+            if (variable.batch == nullptr) continue;
+
+            if (variable.lane >= 0)
+            {
+                apply_lane(variable, variable.lane);
+            }
+
+            std::fill(variable.lane_inputs.begin(), variable.lane_inputs.end(), 0);
+            variable.lane = -1;
+        }
+
+        lanes_used = 0;
+    }
+
+    auto snapshot(const Variable& variable, int lane) const noexcept -> PinSnapshot
+    {
+        PinSnapshot pins{ {}, {}, lane };
+
+        for (const auto& pin : variable.chip->input_pins) pins.inputs.push_back(pin.state);
+        for (const auto& pin : variable.chip->output_pins) pins.outputs.push_back(pin.state);
+
+        return pins;
+    }
+
+    auto restore(Variable& variable, const PinSnapshot& pins) noexcept -> void
+    {
+        for (std::size_t i = 0; i < pins.inputs.size(); i++) variable.chip->input_pins[i].state = pins.inputs[i];
+        for (std::size_t i = 0; i < pins.outputs.size(); i++) variable.chip->output_pins[i].state = pins.outputs[i];
+
+        if (pins.lane >= 0)
+        {
+            apply_lane(variable, pins.lane);
+        }
+    }
+
+    /**
+     * The pins of every declared variable, with their pending lane if 'pending'.
+     */
+    auto snapshot_all(bool pending) const noexcept -> std::vector<std::optional<PinSnapshot>>
+    {
+        std::vector<std::optional<PinSnapshot>> snapshots(variables.size());
+        for (std::size_t slot = 0; slot < variables.size(); slot++)
         {
-            variable.chip->simulate();
+            const auto& variable = variables[slot];
+            if (variable.chip == nullptr) continue;
+            snapshots[slot] = snapshot(variable, pending ? variable.lane : -1);
+        }
+        return snapshots;
+    }
+
+    auto restore_all(const std::vector<std::optional<PinSnapshot>>& snapshots) noexcept -> void
+    {
+        for (std::size_t slot = 0; slot < snapshots.size(); slot++)
+        {
+            if (snapshots[slot].has_value()) restore(variables[slot], *snapshots[slot]);
         }
     }
 
     auto EVAL_statement() noexcept -> void
     {
-        // Simulate...
-        EVAL_impl();
+        program.code.push_back({ .op=TestOp::EVAL, .line=current.line });
         expect_semicolon("Expected semicolon for EVAL statement.");
     }
 
@@ -290,25 +644,25 @@ class Tester : public BaseParser<TestTokenType>
         log("Parsing VARIABLE.");
         if (match(TestTokenType::Number))
         {
-            const auto number = previous.lexeme;
+            const std::string number { previous.lexeme };
             log("Returning numeric constant: " + number);
             return { .type=ValueType::Number, .value=number };
         }
         else if (match(TestTokenType::Identifier)) 
         {
-            const auto varname = previous.lexeme;
+            const std::string varname { previous.lexeme };
 
             consume(TestTokenType::Dot, "Expected '.' after variable name to access member.");
 
             consume(TestTokenType::Identifier, "Expected variable member name.");
-            auto member = previous.lexeme;
+            std::string member { previous.lexeme };
 
             if (match(TestTokenType::LSqaure))
             {
-                consume(TestTokenType::Number, "Expected bus index, found '" + current.lexeme + "'.");
-                const auto bus_index = previous.lexeme;
+                consume(TestTokenType::Number, "Expected bus index, found '" + std::string(current.lexeme) + "'.");
+                const std::string bus_index { previous.lexeme };
 
-                consume(TestTokenType::RSquare, "Expected ']', found '" + current.lexeme + "'.");
+                consume(TestTokenType::RSquare, "Expected ']', found '" + std::string(current.lexeme) + "'.");
 
                 member = member + "[" + bus_index + "]";
             }
@@ -326,144 +680,130 @@ class Tester : public BaseParser<TestTokenType>
         }
     }
 
-    auto get_value(const Value& value) noexcept -> int 
+    /**
+     * Resolve a value into an operand of the program, reporting unknown
+     * variables and members. Returns the index of the operand.
+     */
+    auto resolve(const Value& value) noexcept -> std::optional<std::uint32_t>
     {
+        Operand operand{};
+
         switch (value.type)   
         {
             break; case ValueType::Number:
             {
-                return std::stoi(value.value);
+                operand.kind = Operand::Kind::Constant;
+                operand.value = static_cast<std::size_t>(std::stoi(value.value));
+                operand.text = value.value;
             }
             break; case ValueType::Member:
             {
                 // Make sure the variable exists.
-                if (variables.count(value.value) == 0)
+                if (symbols.count(value.value) == 0)
                 {
                     report_error("Variable '" + value.value + "' not found.");
-                    return 0;
+                    return {};
                 }
 
-                auto& variable = variables.at(value.value);
+                // Members are resolved once per TEST.
+                operand.text = value.value + "." + value.member;
+                if (const auto known = members.find(operand.text); known != members.end())
+                {
+                    return known->second;
+                }
+
+                const auto slot = symbols.at(value.value);
+                const auto* chip_info = slot_types[slot];
 
                 // Check if the value exists as a member.
-                if (!variable.values.contains(value.member))
+                if (!chip_info->meta->has_member(value.member))
                 {
                     report_error("Member '" + value.member + "' not found in '" + value.value + "'.");
-                    return 0;
+                    return {};
                 }
 
-                // Now we get the pin number and set it. 
-                const auto& pin = variable.chip_info->meta->get_pin(value.member);
-                const auto& bus = variable.chip_info->meta->get_bus(value.member);
+                const auto& pin = chip_info->meta->get_pin(value.member);
+                const auto& bus = chip_info->meta->get_bus(value.member);
 
+                std::size_t start{ 0 };
                 if (bus.has_value())
                 {
-                    const auto& [name, start, size] = bus.value();
-                    const auto& pins = variable.chip->input_pins;
-                    const bool is_input { start < MAX_INPUT_PINS };
-
-
-                    std::size_t offset = is_input 
-                                       ? 0 
-                                       : MAX_INPUT_PINS;
-
-                    std::vector<Pin>& target = is_input 
-                                             ? variable.chip->input_pins 
-                                             : variable.chip->output_pins;
-
-                    std::size_t so = pinvec_to_uint(target, start - offset, start + size - offset);
-
-                    return so;
+                    start = bus->start;
+                    operand.width = static_cast<std::uint32_t>(bus->size);
+                    operand.bus = true;
                 }
                 else if (pin.has_value())
                 {
-                    const auto pin_number = pin.value().pin_number;
-                    return (variable.chip->get_pin(pin_number)->is_active()) ? 1 : 0;
+                    start = pin->pin_number;
+                    operand.width = 1;
+                }
+                else
+                {
+                    report_error(value.value + value.member + " is not of type bus or pin.");
+                    return {};
                 }
 
-                // Should be unreachable.
-                report_error(value.value + value.member + " is not of type bus or pin.");
-                return 0;
+                const bool is_input{ start < MAX_INPUT_PINS };
+                operand.kind = is_input ? Operand::Kind::Input : Operand::Kind::Output;
+                operand.start = static_cast<std::uint32_t>(is_input ? start : start - MAX_INPUT_PINS);
+                operand.variable = slot;
             }
         }
-        // Should be unreachable.
-        report_error("Something went VERY wrong.");
-        return 0;
-    }
-    
-    auto get_representation(const Value& value) noexcept -> std::string 
-    {
-        switch (value.type)   
+
+        const auto index = static_cast<std::uint32_t>(program.operands.size());
+        if (operand.kind != Operand::Kind::Constant)
         {
-            break; case ValueType::Number:
-            {
-                return value.value;
-            }
-            break; case ValueType::Member:
-            {
-                return value.value + "." + value.member;
-            }
+            members[operand.text] = index;
         }
-        // Should be unreachable.
-        report_error("Something went VERY wrong.");
-        return "";
+
+        program.operands.push_back(std::move(operand));
+        return index;
     }
 
-    auto SET_impl(const Value& var, const Value& value) noexcept -> void
+    auto get_value(const Operand& operand) noexcept -> std::size_t
     {
-        if (var.type == ValueType::Number)
+        if (operand.kind == Operand::Kind::Constant)
         {
-            report_error("Invalid SET statement, cannot set a constant value.");
-            return;
+            return operand.value;
         }
 
-        // Make sure the variable exists.
-        if (variables.count(var.value) == 0)
-        {
-            report_error("Variable '" + var.value + "' not found.");
-            return;
-        }
+        const auto& variable = variables[operand.variable];
+        const auto& pins = (operand.kind == Operand::Kind::Input) 
+                         ? variable.chip->input_pins 
+                         : variable.chip->output_pins;
+
+        return pinvec_to_uint(pins, operand.start, operand.start + operand.width);
+    }
 
-        auto& variable = variables.at(var.value);
+    auto SET_impl(const TestInstruction& instruction) noexcept -> void
+    {
+        const auto& target = program.operands[instruction.a];
+        const auto& source = program.operands[instruction.b];
 
-        // Check if the value exists as a member.
-        if (!variable.values.contains(var.member))
+        // The value may be the output of an EVAL which has not been evaluated yet.
+        if (source.kind != Operand::Kind::Constant)
         {
-            report_error("Member '" + var.member + "' not found in '" + var.value + "'.");
-            return;
+            flush_batch();
         }
 
-        std::size_t int_val = get_value(value);
-
-        // Now we get the pin number and set it. 
-        const auto& pin = variable.chip_info->meta->get_pin(var.member);
-        const auto& bus = variable.chip_info->meta->get_bus(var.member);
+        const std::size_t int_val = get_value(source);
+        auto& pins = variables[target.variable].chip->input_pins;
 
-        if (bus.has_value())
+        if (target.bus)
         {
-            const auto& [name, start, size] = bus.value();
-            auto& pins = variable.chip->input_pins;
-
-            if ((int_val >> size) > 0)
+            if ((int_val >> target.width) > 0)
             {
-                report_error("Bus overflow. Max: " + std::to_string(_priv::pow2(size)-1) + ", got: " + std::to_string(int_val));
+                report_error_at(instruction.line, "Bus overflow. Max: " + std::to_string(_priv::pow2(target.width)-1) + ", got: " + std::to_string(int_val));
                 return;
             }
 
             // Apply bitmask.
-            set_pinvec(int_val, pins, start, start+size);
-        }
-        else if (pin.has_value())
-        {
-            const auto pin_number = pin.value().pin_number;
-
-            variable.chip->input_pins[pin_number].state = (int_val == 1) ? PinState::ACTIVE : PinState::INACTIVE;
+            set_pinvec(int_val, pins, target.start, target.start + target.width);
         }
         else
         {
-             report_error("Pin '" + var.member + "' not found in meta data.");
+            pins[target.start].state = (int_val == 1) ? PinState::ACTIVE : PinState::INACTIVE;
         }
-
     }
 
     auto SET_statement() noexcept -> void
@@ -479,7 +819,27 @@ class Tester : public BaseParser<TestTokenType>
 
         expect_semicolon("Expected ';' at the end of SET statement.");
 
-        SET_impl(var, val);
+        if (var.type == ValueType::Number)
+        {
+            report_error("Invalid SET statement, cannot set a constant value.");
+            return;
+        }
+
+        const auto target = resolve(var);
+        const auto source = target.has_value() ? resolve(val) : std::nullopt;
+
+        if (!target.has_value() || !source.has_value())
+        {
+            return;
+        }
+
+        if (program.operands[*target].kind != Operand::Kind::Input)
+        {
+            report_error("Invalid SET statement, '" + program.operands[*target].text + "' is not an input.");
+            return;
+        }
+
+        program.code.push_back({ .op=TestOp::SET, .a=*target, .b=*source, .line=previous.line });
 
         log("Finished parsing SET statement.");
     }
@@ -515,21 +875,24 @@ class Tester : public BaseParser<TestTokenType>
         return { .a=var, .b=val, .type=type };
     }
 
-    auto REQUIRE_impl(std::vector<Condition>& conditions) noexcept -> void
+    auto REQUIRE_impl(const TestInstruction& instruction) noexcept -> void
     {
-        const auto& test_name = board_ptr->context().first;
         bool expected = true;
-        for (const auto& cond : conditions)
+        for (std::uint32_t i = instruction.a; i < instruction.a + instruction.b; i++)
         {
+            const auto& cond = program.conditions[i];
+            const auto& a = program.operands[cond.a];
+            const auto& b = program.operands[cond.b];
+
             switch (cond.type)
             {
                 break; case ConditionType::IS:
                 {
-                    expected = (get_value(cond.a)==get_value(cond.b));
+                    expected = (get_value(a)==get_value(b));
                 }
                 break; case ConditionType::NOT:
                 {
-                    expected = (get_value(cond.a)!=get_value(cond.b));
+                    expected = (get_value(a)!=get_value(b));
                 }
             }
 
@@ -539,20 +902,20 @@ class Tester : public BaseParser<TestTokenType>
               auto cond_op = cond.type == ConditionType::IS ? "==" : "!=";
               std::stringstream ss;
 
-              ss << "[ Line " << std::to_string(current.line) << " ] REQUIRE " 
-                 << get_representation(cond.a) 
+              ss << "[ Line " << std::to_string(instruction.line) << " ] REQUIRE " 
+                 << a.text 
                  << " " 
                  << cond_op 
                  << " "
-                 << get_representation(cond.b)
+                 << b.text
                  << " -> "
                  << "\033[1;31m"
                  << "REQUIRE "
-                 << get_value(cond.a) 
+                 << get_value(a) 
                  << " " 
                  << cond_op 
                  << " "
-                 << get_value(cond.b)
+                 << get_value(b)
                  << "\033[0m";
 
               failed_messages.emplace_back(ss.str());
@@ -561,33 +924,97 @@ class Tester : public BaseParser<TestTokenType>
         }
     }
 
+    /**
+     * Batched mode: check the REQUIRE once its EVALs have been evaluated.
+     */
+    auto defer_REQUIRE(const TestInstruction& instruction) noexcept -> void
+    {
+        deferred_requires.push_back({ instruction, snapshot_all(true) });
+    }
+
     auto REQUIRE_statement() noexcept -> void
     {
         log("Parsing REQUIRE statement.");
 
-        std::vector<Condition> conditions;
+        std::vector<CompiledCondition> conditions;
 
-        if (auto cond = parse_condition(); !has_error)
+        const auto compile_condition = [&]
         {
-            conditions.push_back(std::move(cond));
-        }
+            const auto cond = parse_condition();
+            if (has_error) return;
 
-        while (match(TestTokenType::And))
-        {
-            if (auto cond = parse_condition(); !has_error)
+            const auto a = resolve(cond.a);
+            const auto b = a.has_value() ? resolve(cond.b) : std::nullopt;
+            if (a.has_value() && b.has_value())
             {
-                conditions.push_back(std::move(cond));
+                conditions.push_back({ *a, *b, cond.type });
             }
+        };
+
+        compile_condition();
+
+        while (match(TestTokenType::And))
+        {
+            compile_condition();
         }
 
         expect_semicolon("Expected ';' at the end of REQUIRE statement.");
 
         if (!has_error)
-            REQUIRE_impl(conditions);
+        {
+            const auto first = static_cast<std::uint32_t>(program.conditions.size());
+            program.conditions.insert(program.conditions.end(), conditions.begin(), conditions.end());
+            program.code.push_back({ 
+                .op=TestOp::REQUIRE, 
+                .a=first, 
+                .b=static_cast<std::uint32_t>(conditions.size()), 
+                .line=current.line 
+            });
+        }
 
         log("Finished parsing REQUIRE statement.");
     }
 
+    /**
+     * Run the compiled TEST body.
+     */
+    auto run(const TestProgram& compiled) noexcept -> void
+    {
+        variables.resize(compiled.variables.size());
+
+        for (const auto& instruction : compiled.code)
+        {
+            switch (instruction.op)
+            {
+                break; case TestOp::VAR: VAR_impl(instruction);
+                break; case TestOp::SET: SET_impl(instruction);
+                break; case TestOp::EVAL: EVAL_impl(instruction);
+                break; case TestOp::REQUIRE: 
+                {
+                    if (has_error) continue;
+
+                    if (lanes_used > 0) defer_REQUIRE(instruction);
+                    else REQUIRE_impl(instruction);
+                }
+            }
+        }
+    }
+
+    /**
+     * Report an error found while running a program, at the line of its statement.
+     */
+    auto report_error_at(std::size_t line, std::string_view message) noexcept -> void
+    {
+        if (this->panic)
+            return;
+
+        this->panic = true;
+
+        *output << "ERROR [ (line:" << line << ") " << message << " ]\n";
+
+        this->has_error = true;
+    }
+
     auto parse_TEST_body() noexcept -> void
     {
         log("Parsing TEST body");
@@ -615,7 +1042,7 @@ class Tester : public BaseParser<TestTokenType>
             else if (match(TestTokenType::EndOfFile))
             {
                 report_error("CHIP definition not terminated, expected '}', found '" +
-                             current.lexeme + "'.");
+                             std::string(current.lexeme) + "'.");
                 return;
             }
             else
@@ -631,6 +1058,10 @@ class Tester : public BaseParser<TestTokenType>
     {
         test_failed = false;
         purge_variables();
+        program = {};
+        symbols.clear();
+        slot_types.clear();
+        members.clear();
         board_ptr->reset_context();
         board_ptr->create_new(test);
         board_ptr->set_context(test);
@@ -647,26 +1078,76 @@ class Tester : public BaseParser<TestTokenType>
 
         TEST_impl(test_name);
 
-        // Parsing body.
+        // The body is compiled first and then run.
         parse_TEST_body();
 
+        for (const auto& [_, slot] : symbols)
+        {
+            program.step_order.push_back(slot);
+        }
+
+        run(program);
+        flush_batch();
+
         const auto passed = !(test_failed || has_error);
         const auto status = passed ? "\033[1;32mPASSED \033[0m" : "\033[1;31mFAILED \033[0m";
-        std::cout << "[ Test: " << test_name << "] " << status << '\n';
+        *output << "[ Test: " << test_name << "] " << status << '\n';
+        (passed ? passed_tests : failed_tests)++;
 
         if (!failed_messages.empty())
         {
-            std::cout << "    [ Required Failed ]\n";
+            *output << "    [ Required Failed ]\n";
             for (const auto& message : failed_messages)
             {
-                std::cout << "    " << message << '\n';
+                *output << "    " << message << '\n';
             }
             failed_messages.clear();
         }
 
+        if (!unsettled_messages.empty())
+        {
+            *output << "    [ Did not settle ]\n";
+            for (const auto& message : unsettled_messages)
+            {
+                *output << "    " << message << '\n';
+            }
+            unsettled_messages.clear();
+        }
+
+        if (board_ptr->reports_activity())
+        {
+            report_activity();
+        }
+
         log("Finished parsing TEST statement.");
     }
 
+    /**
+     * Print how much of the compiled circuits was evaluated per EVAL.
+     */
+    auto report_activity() const noexcept -> void
+    {
+        Activity activity{};
+        std::size_t instructions{ 0 };
+
+        for (const auto& variable : variables)
+        {
+            if (variable.instance == nullptr) continue;
+            activity += variable.instance->get_circuit().get_activity();
+            instructions += variable.instance->get_circuit().get_netlist().instructions.size();
+        }
+
+        if (activity.steps == 0) return;
+
+        const auto steps = static_cast<double>(activity.steps);
+        const auto evaluations = static_cast<double>(activity.evaluations) / steps;
+
+        *output << "    [ Activity: " << activity.steps << " EVAL, "
+                  << static_cast<double>(activity.events) / steps << " events/EVAL, "
+                  << evaluations << " evaluations/EVAL over "
+                  << instructions << " instructions ]\n";
+    }
+
     auto restabilize() noexcept -> void
     {
         // Reset panic flag, since now we can report a new error for a different part.
@@ -689,14 +1170,45 @@ class Tester : public BaseParser<TestTokenType>
     auto purge_variables() noexcept -> void
     {
         variables.clear();   
+        deferred_requires.clear();
+        lanes_used = 0;
+
+        // Release the gates of the previous test all at once.
+        test_arena = std::make_unique<GateArena>();
     }
 
 private:
     Board*                          board_ptr;
     bool                            test_failed;
+
+    /**
+     * The chip images live as long as the tester, the variables only as long as
+     * their test. Both have to outlive what was allocated in them.
+     */
+    GateArena                       image_arena{};
+    std::unique_ptr<GateArena>      test_arena{ std::make_unique<GateArena>() };
     std::map<std::string, ChipInfo> chip_images;
-    std::map<std::string, Variable> variables; 
+    std::vector<Variable>           variables; 
+
+    /**
+     * The TEST being compiled: its program, the slot of every variable name,
+     * the chip type of every slot and the operands of the members resolved so far.
+     */
+    TestProgram                          program{};
+    std::map<std::string, std::uint16_t> symbols{};
+    std::vector<ChipInfo*>               slot_types{};
+    std::map<std::string, std::uint32_t> members{};
     std::vector<std::string>        failed_messages;
+    std::vector<std::string>        unsettled_messages;
+    std::vector<DeferredRequire>    deferred_requires;
+    std::size_t                     lanes_used{ 0 };
+    std::size_t                     passed_tests{ 0 };
+    std::size_t                     failed_tests{ 0 };
+
+    /**
+     * Set by a MODE statement, the board's mode otherwise.
+     */
+    std::optional<SimulationMode>   file_mode{};
 };
 
 } /* namespace test */
@@ -446,7 +446,7 @@ public:
    handle_return();
   else
   {
-   const std::string current = this->current.lexeme;
+   const std::string current { this->current.lexeme };
    report_error("Invalid token: " + current);
   }
 
@@ -466,7 +466,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected value after 'constant'");
-     const std::uint16_t value = std::stoi(previous.lexeme);
+     const std::uint16_t value = std::stoi(std::string(previous.lexeme));
 
      this->code.emit_instruction(Opcode::PUSH_CONSTANT);
      this->code.emit(value);
@@ -475,7 +475,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'static'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
      const uint16_t address = get_symbol("STATIC_" + index);
 
      this->code.emit_instruction(Opcode::PUSH_STATIC);
@@ -486,7 +486,7 @@ public:
      advance();
      consume(TokenType::Number, "Expected index after 'temp'");
 
-     const std::string index_string = previous.lexeme;
+     const std::string index_string { previous.lexeme };
      const uint32_t offset = std::stoi(index_string);
 
      if (offset > 7) report_error("Temp index out of range: " + index_string);
@@ -497,7 +497,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'pointer'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
 
      if (index != "1" && index != "0") report_error("Invalid pointer for push");
 
@@ -518,11 +518,11 @@ public:
  auto write_push_segment() -> void
  {
   advance();
-  const std::string segment_name = previous.lexeme;
+  const std::string segment_name { previous.lexeme };
   consume(TokenType::Number, "Expected index after '" + segment_name + "'");
 
   // Offset index (from segment).
-  const uint16_t offset = std::stoi(previous.lexeme);
+  const uint16_t offset = std::stoi(std::string(previous.lexeme));
   this->code.emit(offset);
  }
 
@@ -535,7 +535,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'static'");
-     const std::string index_str = previous.lexeme;
+     const std::string index_str { previous.lexeme };
      const uint16_t index = std::stoi(index_str);
 
      this->code.emit_instruction(Opcode::POP_STATIC);
@@ -545,7 +545,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'temp'");
-     const std::string index_str = previous.lexeme;
+     const std::string index_str { previous.lexeme };
      const uint32_t index = std::stoi(index_str);
 
      if (index > 7) report_error("Temp index out of range: " + index_str);
@@ -557,7 +557,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'pointer'");
-     const std::string index_str = previous.lexeme;
+     const std::string index_str { previous.lexeme };
      const uint16_t index = std::stoi(index_str);
 
      if (index_str != "1" && index_str != "0") report_error("Invalid pointer for pop");
@@ -576,9 +576,9 @@ public:
  auto write_pop_segment(std::string_view segment) -> void
  {
      advance();
-     const std::string segment_name = previous.lexeme;
+     const std::string segment_name { previous.lexeme };
      consume(TokenType::Number, "Expected index after '" + segment_name + "'");
-     const std::string index_str = previous.lexeme;
+     const std::string index_str { previous.lexeme };
      const uint16_t index = std::stoi(index_str);
 
      this->code.emit(index);
@@ -632,7 +632,7 @@ public:
  auto handle_label() -> void
  {
   consume(TokenType::Identifier, "Expected label name");
-  const std::string label_name = previous.lexeme;
+  const std::string label_name { previous.lexeme };
   const uint16_t label_value = get_symbol(label_name);
 
   this->code.emit_instruction(Opcode::LABEL);
@@ -643,7 +643,7 @@ public:
  auto handle_goto() -> void
  {
   consume(TokenType::Identifier, "Expected label name");
-  const std::string label_name = previous.lexeme;
+  const std::string label_name { previous.lexeme };
 
   this->code.emit_instruction(Opcode::GOTO);
   this->code.emit(get_symbol(label_name));
@@ -654,7 +654,7 @@ public:
   consume(TokenType::Dash, "Expected '-' after if");
   consume(TokenType::Goto, "Expected 'goto' after '-'");
   consume(TokenType::Identifier, "Expected label name");
-  const std::string label_name = previous.lexeme;
+  const std::string label_name { previous.lexeme };
 
   this->code.emit_instruction(Opcode::IF);
   this->code.emit(get_symbol(label_name));
@@ -663,12 +663,12 @@ public:
  auto handle_call() -> void
  {
   consume(TokenType::Identifier, "Expected file name");
-  const std::string file_name = previous.lexeme;
+  const std::string file_name { previous.lexeme };
   consume(TokenType::Dot, "Expected function name");
   advance();
-  const std::string function_name = previous.lexeme;
+  const std::string function_name { previous.lexeme };
   consume(TokenType::Number, "Expected function args count");
-  const std::string n_args_str = previous.lexeme;
+  const std::string n_args_str { previous.lexeme };
   const uint16_t n_args = std::stoi(n_args_str);
   const std::string function_path = file_name + "." + function_name;
 
@@ -680,12 +680,12 @@ public:
  auto handle_function() -> void
  {
   consume(TokenType::Identifier, "Expected file name");
-  const std::string file_name = previous.lexeme;
+  const std::string file_name { previous.lexeme };
   consume(TokenType::Dot, "Expected function name");
   advance();
-  const std::string function_name = previous.lexeme;
+  const std::string function_name { previous.lexeme };
   consume(TokenType::Number, "Expected variable count");
-  const std::string n_args_str = previous.lexeme;
+  const std::string n_args_str { previous.lexeme };
   const uint16_t n_args = std::stoi(n_args_str);
   const std::string function_path = file_name + "." + function_name;
 
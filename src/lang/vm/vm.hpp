@@ -227,7 +227,7 @@ public:
    handle_return();
   else
   {
-   const std::string current = this->current.lexeme;
+   const std::string current { this->current.lexeme };
    report_error("Invalid token: " + current);
   }
 
@@ -238,9 +238,9 @@ public:
  auto write_pop_segment(std::string_view segment) -> void
  {
      advance();
-     const std::string segment_name = previous.lexeme;
+     const std::string segment_name { previous.lexeme };
      consume(TokenType::Number, "Expected index after '" + segment_name + "'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
      m_builder.write_comment("pop", segment_name, index)
               .write_A("SP")
               .write_assignment("M", "M-1")
@@ -261,9 +261,9 @@ public:
  auto write_push_segment(std::string_view segment) -> void
  {
      advance();
-     const std::string segment_name = previous.lexeme;
+     const std::string segment_name { previous.lexeme };
      consume(TokenType::Number, "Expected index after '" + segment_name + "'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
      m_builder.write_comment("push", segment_name, index)
               .write_A(segment)
               .write_assignment("D", "M")
@@ -305,7 +305,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'constant'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
 
      push_constant(index);
     }
@@ -313,7 +313,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'static'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
 
      m_builder.write_comment("push static", index)
               .write_A(m_filename, index)
@@ -329,7 +329,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'temp'");
-     const std::string index_string = previous.lexeme;
+     const std::string index_string { previous.lexeme };
      const uint32_t index = std::stoi(index_string);
 
      if (index > 7) report_error("Temp index out of range: " + index_string);
@@ -348,7 +348,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'pointer'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
 
      if (index != "1" && index != "0") report_error("Invalid pointer for push");
 
@@ -426,7 +426,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'static'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
 
      m_builder.write_comment("pop static", index)
               .write_A("SP")
@@ -441,7 +441,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'temp'");
-     const std::string index_string = previous.lexeme;
+     const std::string index_string { previous.lexeme };
      const uint32_t index = std::stoi(index_string);
 
      if (index > 7) report_error("Temp index out of range: " + index_string);
@@ -459,7 +459,7 @@ public:
     {
      advance();
      consume(TokenType::Number, "Expected index after 'pointer'");
-     const std::string index = previous.lexeme;
+     const std::string index { previous.lexeme };
 
      if (index != "1" && index != "0") report_error("Invalid pointer for pop");
 
@@ -630,14 +630,14 @@ public:
  auto handle_label() -> void
  {
   consume(TokenType::Identifier, "Expected label name");
-  const std::string label_name = previous.lexeme;
+  const std::string label_name { previous.lexeme };
   m_builder.write_label(label_name);
  }
  
  auto handle_goto() -> void
  {
   consume(TokenType::Identifier, "Expected label name");
-  const std::string label_name = previous.lexeme;
+  const std::string label_name { previous.lexeme };
   m_builder.write_A(label_name)
            .write_jump("0", "JMP");
  }
@@ -647,7 +647,7 @@ public:
   consume(TokenType::Dash, "Expected '-' after if");
   consume(TokenType::Goto, "Expected 'goto' after '-'");
   consume(TokenType::Identifier, "Expected label name");
-  const std::string label_name = previous.lexeme;
+  const std::string label_name { previous.lexeme };
   m_builder.write_A("SP")
            .write_assignment("AM", "M-1")
            .write_assignment("D", "M")
@@ -729,12 +729,12 @@ public:
  auto handle_call() -> void
  {
   consume(TokenType::Identifier, "Expected file name");
-  const std::string file_name = previous.lexeme;
+  const std::string file_name { previous.lexeme };
   consume(TokenType::Dot, "Expected function name");
   advance();
-  const std::string function_name = previous.lexeme;
+  const std::string function_name { previous.lexeme };
   consume(TokenType::Number, "Expected function args count");
-  const std::string n_args = previous.lexeme;
+  const std::string n_args { previous.lexeme };
 
   call(file_name, function_name, n_args);
  }
@@ -742,12 +742,12 @@ public:
  auto handle_function() -> void
  {
   consume(TokenType::Identifier, "Expected file name");
-  const std::string file_name = previous.lexeme;
+  const std::string file_name { previous.lexeme };
   consume(TokenType::Dot, "Expected function name");
   advance();
-  const std::string function_name = previous.lexeme;
+  const std::string function_name { previous.lexeme };
   consume(TokenType::Number, "Expected variable count");
-  const std::string n_args_str = previous.lexeme;
+  const std::string n_args_str { previous.lexeme };
   const uint16_t n_args = std::stoi(n_args_str);
 
   m_builder.write_comment("function", file_name+'.'+function_name, n_args_str)
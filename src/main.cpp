@@ -22,13 +22,23 @@
  * SOFTWARE.
  */
 
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <string>
 #include <string_view>
 #include <filesystem>
+#include <random>
+#include <set>
+#include <sstream>
 
 #include "common.hpp" 
 #include "board.hpp"
+#include "build_manifest.hpp"
+#include "build_plan.hpp"
+#include "gate_image.hpp"
+#include "thread_pool.hpp"
 
 #ifdef GUI_ENABLED
 #include "gui/driver.hpp"
@@ -79,7 +89,7 @@ void show_truth_table(RawParser& parser)
 	}
 
 	// Get the component name.
-	const auto& name = token.lexeme;
+	const std::string name { token.lexeme };
 
 	if (auto component = board->get_component(name); component != nullptr)
 	{
@@ -107,17 +117,86 @@ void show_list(RawParser& parser)
 
 void compile(RawParser& parser);
 
-void compile_all()
+/**
+ * Reload the loaded chips which use the given (just reloaded) chip, they hold copies of the old one.
+ */
+void reload_users(const std::string& name);
+
+/**
+ * Compile every out of date chip of the scripts directory (all of them if forced),
+ * independent chips in parallel, then load what changed in dependency order.
+ */
+void compile_all(bool force)
 {
-	RawParser p;
-	for (const auto& gate : std::filesystem::directory_iterator(SCRIPTS_DIR))
-  {
-		if (gate.path().extension() == HDL_EXTENSION)
+	const auto start = std::chrono::steady_clock::now();
+
+	auto manifest = BuildManifest::load();
+	const auto plan = BuildPlan::scan();
+	const auto results = plan.build(ThreadPool::instance(), manifest, force);
+	manifest.save();
+
+	// Loaded chips hold copies of the chips they use, so users of a reloaded chip are reloaded as well.
+	// Chips which are not loaded are (re)registered, they are loaded from the new files once used.
+	auto board = Board::instance();
+	std::set<std::string> reloaded{};
+	std::size_t compiled{}, up_to_date{}, failed{}, skipped{};
+
+	for (const auto& result : results)
+	{
+		switch (result.status)
+		{
+			break; case BuildStatus::Compiled:
+			{
+				compiled++;
+				log("Compiled '", result.chip, "'.");
+			}
+			break; case BuildStatus::UpToDate:
+			{
+				up_to_date++;
+			}
+			break; case BuildStatus::Failed:
+			{
+				failed++;
+				error("Failed to compile '" + result.chip + "'.");
+				std::cout << result.message;
+				continue;
+			}
+			break; case BuildStatus::Skipped:
+			{
+				skipped++;
+				error("Skipped '" + result.chip + "', it uses '" + result.message + "' which could not be compiled.");
+				continue;
+			}
+		}
+
+		const auto path = GATE_RECIPE_DIRECTORY + result.chip + GATE_EXTENSION;
+		if (!board->found(result.chip))
+		{
+			board->register_file(result.chip, path);
+			continue;
+		}
+
+		const auto& used = plan.dependencies(result.chip);
+		const bool stale = result.changed
+		                || std::any_of(used.begin(), used.end(), [&](const std::string& chip) { return reloaded.contains(chip); });
+
+		if (!stale)
+		{
+			continue;
+		}
+
+		if (!run_file(path))
 		{
-			p.set_source(gate.path().stem());
-			compile(p);
+			error("Failed to load file '" + result.chip + "'.");
+			continue;
 		}
+
+		reloaded.insert(result.chip);
 	}
+
+	const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	log("Compiled ", compiled, ", up to date ", up_to_date, ", failed ", failed, ", skipped ", skipped,
+	    " (", plan.get_levels().size(), " levels) in ", elapsed.count(), "ms.");
 }
 
 void compile(RawParser& parser)
@@ -126,7 +205,8 @@ void compile(RawParser& parser)
 
 	if (token.type == RawTokenType::Identifier && token.lexeme == "all")
 	{
-		compile_all();
+		const auto option = parser.advance_token();
+		compile_all(option.type == RawTokenType::Identifier && option.lexeme == "force");
 		return;
 	}
 
@@ -137,55 +217,79 @@ void compile(RawParser& parser)
 	}
 
 	// Get the component name.
-	const auto& name = token.lexeme;
+	const std::string name { token.lexeme };
+	const auto gate = GATE_RECIPE_DIRECTORY + name + GATE_EXTENSION;
 
-	auto hdl_parser = hdl::HDLParser(hdl_file(name));
+	auto manifest = BuildManifest::load();
+	const auto parts = BuildPlan::parts_of(hdl_file(name));
+	const auto loaded = Board::instance()->found(name);
 
-	if (hdl_parser.error_occured())
+	if (manifest.is_up_to_date(name, parts) && Board::instance()->known(name))
 	{
-		error("Failed to open file '" + name + "'.");
+		log("'", name, "' is up to date.");
 		return;
 	}
 
-	if (!hdl_parser.parse())
+	const auto before = BuildManifest::hash_file(gate);
+
+	// Writes the .gate file, its binary form and the .meta file.
+	if (!Board::compile_recipe(name, std::cout))
 	{
-		error("Failed to parse file '" + name + "'.");
+		error("Failed to compile '" + name + "'.");
 		return;
 	}
 
-	const auto result = hdl_parser.result();
-
-	// Gate file.
-  std::ofstream gate_file { 
-    DEFAULT_GATE_DIRECTORY + 
-    std::string("/") +  
-    DEFAULT_RECIPE_SAVE_DIRECTORY + 
-    std::string("/") +  
-    name + 
-    GATE_EXTENSION 
-  };
-	gate_file << result.compile();
-	gate_file.close();
-
-	// Meta file.
-  std::ofstream meta_file { 
-    SCRIPTS_DIR + 
-    std::string("/") +  
-    name + 
-    META_EXTENSION 
-  };
-	meta_file << result.meta();
-	meta_file.close();
+	manifest.record(name, parts);
+	manifest.save();
 
+	if (loaded && BuildManifest::hash_file(gate) == before)
+	{
+		log("Successfully compiled '", name, "', it did not change.");
+		return;
+	}
 
 	// Attemp to load the chip.
-	if (!run_file(GATE_RECIPE_DIRECTORY + name + GATE_EXTENSION))
+	if (!run_file(gate))
 	{
 		error("Failed to load file '" + name + "'.");
 		return;
 	}
 
 	log("Successfully compiled and loaded '", name, "'.");
+
+	if (loaded)
+	{
+		reload_users(name);
+	}
+}
+
+void reload_users(const std::string& name)
+{
+	const auto board = Board::instance();
+	const auto plan = BuildPlan::scan();
+	std::set<std::string> reloaded{ name };
+
+	for (const auto& level : plan.get_levels())
+	{
+		for (const auto& chip : level)
+		{
+			const auto& used = plan.dependencies(chip);
+			if (!board->found(chip) || std::none_of(used.begin(), used.end(), [&](const std::string& dependency) { return reloaded.contains(dependency); }))
+			{
+				continue;
+			}
+
+			if (run_file(GATE_RECIPE_DIRECTORY + chip + GATE_EXTENSION))
+			{
+				reloaded.insert(chip);
+			}
+		}
+	}
+
+	if (reloaded.size() > 1)
+	{
+		log("Reloaded ", reloaded.size() - 1, " chips using '", name, "'.");
+	}
 }
 
 void load(RawParser& parser)
@@ -199,17 +303,19 @@ void load(RawParser& parser)
 	}
 
 	// Get the component name.
-	const std::string& name = token.lexeme;
-
-	const auto component_names = Board::instance()->get_names();
-	auto found = std::find(component_names.begin(), component_names.end(), name);
+	const std::string name { token.lexeme };
 
-	if (found != component_names.end())
+	if (Board::instance()->found(name))
 	{
 		log("Chip '", name, "' already loaded.");
 		return;
 	}
 
+	if (BuildManifest::load().is_source_changed(name))
+	{
+		info("'" + name + ".hdl' changed since it was compiled, 'compile " + name + "' to update it.");
+	}
+
 	// Attemp to load the chip.
 	if (!run_file(GATE_RECIPE_DIRECTORY + name + GATE_EXTENSION))
 	{
@@ -220,17 +326,96 @@ void load(RawParser& parser)
 	log("Sucessfully loaded '", name, "'.");
 }
 
-void run_all_tests()
+struct TestFileResult
 {
-	for (const auto& gate : std::filesystem::directory_iterator(SCRIPTS_DIR))
-  {
-		if (gate.path().extension() == TEST_EXTENSION)
+	std::ostringstream output{};
+	std::size_t        passed{};
+	std::size_t        failed{};
+	double             seconds{};
+};
+
+/**
+ * Every test file of the scripts directory, sorted by name.
+ */
+auto test_files() -> std::vector<std::filesystem::path>
+{
+	std::vector<std::filesystem::path> files{};
+	for (const auto& entry : std::filesystem::directory_iterator(SCRIPTS_DIR))
+	{
+		if (entry.path().extension() == TEST_EXTENSION)
 		{
-			log("Test file: " + std::string(gate.path()));
-			test::Tester tester(gate.path());
-			static_cast<void>(tester.parse());
+			files.push_back(entry.path());
 		}
 	}
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+/**
+ * Run the test files on the thread pool. Each file gets a Board of its own
+ * (with the settings of the given board) and its output is collected.
+ */
+auto run_test_files(const std::vector<std::filesystem::path>& files, const Board& settings) 
+	-> std::vector<TestFileResult>
+{
+	using Clock = std::chrono::steady_clock;
+
+	std::vector<TestFileResult> results(files.size());
+	ThreadPool::instance().parallel_for(files.size(), [&](std::size_t i)
+	{
+		const auto file_start = Clock::now();
+		auto& result = results[i];
+
+		Board board{ false };
+		board.inherit_settings(settings);
+
+		test::Tester tester(files[i].string(), &board, result.output);
+		static_cast<void>(tester.parse());
+
+		result.passed = tester.passed_count();
+		result.failed = tester.failed_count();
+		result.seconds = std::chrono::duration<double>(Clock::now() - file_start).count();
+	});
+
+	return results;
+}
+
+/**
+ * Run every test file with the settings of the main board, then print the
+ * output file by file in order, followed by a summary.
+ */
+void run_all_tests()
+{
+	using Clock = std::chrono::steady_clock;
+	const auto start = Clock::now();
+
+	const auto files = test_files();
+	const auto results = run_test_files(files, *Board::instance());
+
+	const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+	std::size_t passed{ 0 };
+	std::size_t failed{ 0 };
+	for (std::size_t i = 0; i < files.size(); i++)
+	{
+		log("Test file: " + files[i].string());
+		std::cout << results[i].output.str();
+		passed += results[i].passed;
+		failed += results[i].failed;
+	}
+
+	newline();
+	log("Summary:");
+	for (std::size_t i = 0; i < files.size(); i++)
+	{
+		const auto& result = results[i];
+		std::cout << "  " << std::left << std::setw(28) << files[i].filename().string() << std::right
+		          << std::setw(4) << result.passed << " passed " << std::setw(4) << result.failed << " failed "
+		          << std::fixed << std::setprecision(3) << result.seconds << "s\n";
+	}
+	std::cout << std::defaultfloat;
+	log("Total: ", passed, " passed, ", failed, " failed, ", files.size(), " files in ", elapsed.count(),
+	    "s on ", ThreadPool::instance().size(), " threads.");
 }
 
 void run_test(RawParser& parser) 
@@ -250,7 +435,7 @@ void run_test(RawParser& parser)
 	}
 
 	// Get the component name.
-	const std::string& name = token.lexeme;
+	const std::string name { token.lexeme };
 
 	
 	test::Tester tester(SCRIPTS_DIR + SEPERATOR + name + TEST_EXTENSION);
@@ -262,29 +447,395 @@ void run_test(RawParser& parser)
 
 void serialize(RawParser& parser) 
 {
-	auto board = Board::instance();
-	const auto token = parser.advance_token();
-
-	if (token.type != RawTokenType::Identifier)
-	{
-		error("Please input a valid component name.");
-		return;
-	}
-
-	// Get the component name.
-	const auto& name = token.lexeme;
-
-	if (auto component = board->get_component(name); component != nullptr)
-	{
-		component->serialize();
+	auto board = Board::instance();
+	const auto token = parser.advance_token();
+
+	if (token.type != RawTokenType::Identifier)
+	{
+		error("Please input a valid component name.");
+		return;
+	}
+
+	// Get the component name.
+	const std::string name { token.lexeme };
+
+	// Optional cap on the number of inputs.
+	std::size_t input_limit{ SERIALIZE_INPUT_LIMIT };
+	if (const auto limit = parser.advance_token(); limit.type == RawTokenType::Number)
+	{
+		input_limit = std::stoul(std::string(limit.lexeme));
+	}
+
+	if (auto component = board->get_component(name); component != nullptr)
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		if (!component->serialize(input_limit))
+		{
+			error("Component `" + name + "` has " + std::to_string(component->input_pins.size()) 
+			      + " inputs, the limit is " + std::to_string(input_limit) + ".");
+			return;
+		}
+
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+		const auto rows = component->serialized_computation.size();
+
 		// component->print_truth_table();
-		log("Component `", name, "` serialized!");
-	}
-	else
-	{
-		log("Component with given name `", name, "` not found!");
+		log("Component `", name, "` serialized! (", rows, " rows in ", elapsed.count(), "s, ",
+		    static_cast<std::size_t>(rows / std::max(elapsed.count(), 1e-9)), " rows/s, ",
+		    ThreadPool::instance().size(), " threads, ",
+		    component->serialized_computation.memory_usage(), " bytes)");
+	}
+	else
+	{
+		log("Component with given name `", name, "` not found!");
 	}}
 
+/**
+ * Memory used by the name tries: the component search index of the board
+ * and the tries of every .meta file (what loading all of them costs).
+ */
+void index_info()
+{
+	// Bytes the same nodes would take as tables of ASCII_COUNT child pointers.
+	const auto wide = [](std::size_t nodes) { return nodes * ASCII_COUNT * sizeof(void*); };
+
+	const auto& search_index = Board::instance()->get_search_index();
+	log("Search index:          ", search_index.node_count(), " nodes, ", search_index.memory_usage(), " bytes",
+	    " (", wide(search_index.node_count()), " with 256-wide nodes)");
+
+	std::size_t metas{}, nodes{}, bytes{};
+	for (const auto& file : std::filesystem::directory_iterator(SCRIPTS_DIR))
+	{
+		if (file.path().extension() != META_EXTENSION)
+		{
+			continue;
+		}
+
+		if (const auto meta = hdl::Meta::get_meta(file.path().stem().string()))
+		{
+			metas++;
+			nodes += meta->trie.node_count();
+			bytes += meta->trie.memory_usage();
+		}
+	}
+
+	log("Meta tries:            ", metas, " files, ", nodes, " nodes, ", bytes, " bytes",
+	    " (", wide(nodes), " with 256-wide nodes)");
+}
+
+void netlist_info(RawParser& parser)
+{
+	auto board = Board::instance();
+	const auto token = parser.advance_token();
+
+	if (token.type != RawTokenType::Identifier)
+	{
+		error("Please input a valid component name.");
+		return;
+	}
+
+	const std::string name { token.lexeme };
+	auto component = board->get_component(name);
+	if (component == nullptr)
+	{
+		log("Component with given name `", name, "` not found!");
+		return;
+	}
+
+	const auto image = GateImage::create(*component, board);
+	const auto instance = image->instantiate();
+	const auto& netlist = *image->get_netlist();
+
+	// What every instance cost before images, a full copy of the gate tree.
+	const auto tree = component->duplicate(board);
+
+	const auto& optimization = netlist.optimization;
+
+	log("Netlist of `", name, "`");
+	log("  Instructions:       ", netlist.instructions.size(), " (", optimization.operations, " before optimization)");
+	log("  Nets:               ", netlist.net_count, " (", optimization.nets, " before optimization)");
+	log("  Aliased:            ", optimization.aliased);
+	log("  Folded:             ", optimization.folded);
+	log("  Merged:             ", optimization.merged);
+	log("  Removed:            ", optimization.removed);
+	log("  Levels:             ", netlist.level_count);
+	log("  Fanout entries:     ", netlist.fanout.size());
+	log("  Image bytes:        ", image->memory_usage(), " (shared)");
+	log("  Instance bytes:     ", instance->memory_usage(), " (per instance)");
+	log("  Gate tree bytes:    ", tree->memory_usage(), " (per deep copy)");
+}
+
+void bench(RawParser& parser)
+{
+	auto board = Board::instance();
+	const auto token = parser.advance_token();
+
+	if (token.type != RawTokenType::Identifier)
+	{
+		error("Please input a valid component name.");
+		return;
+	}
+
+	const std::string name { token.lexeme };
+	auto component = board->get_component(name);
+	if (component == nullptr)
+	{
+		log("Component with given name `", name, "` not found!");
+		return;
+	}
+
+	std::size_t count{ 100 };
+	if (const auto number = parser.advance_token(); number.type == RawTokenType::Number)
+	{
+		count = std::max<std::size_t>(std::stoul(std::string(number.lexeme)), 1);
+	}
+
+	using Clock = std::chrono::steady_clock;
+	const auto per_instance = [count](Clock::time_point start)
+	{
+		const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+		return elapsed.count() / static_cast<double>(count);
+	};
+
+	// Full copies of the gate tree, every wire is resolved through get_pin.
+	auto start = Clock::now();
+	for (std::size_t i = 0; i < count; i++)
+	{
+		auto copy = component->duplicate(board);
+	}
+	const auto duplicate_time = per_instance(start);
+
+	// Copies which are kept until the end, like the variables of a test.
+	start = Clock::now();
+	{
+		std::vector<std::unique_ptr<Gate>> copies{};
+		for (std::size_t i = 0; i < count; i++)
+		{
+			copies.push_back(component->duplicate(board));
+		}
+	}
+	const auto kept_time = per_instance(start);
+
+	// The same, made inside of an arena and released together.
+	std::size_t arena_bytes{};
+	start = Clock::now();
+	{
+		GateArena arena{};
+		std::vector<std::unique_ptr<Gate>> copies{};
+		{
+			GateArena::Scope scope{ arena };
+			for (std::size_t i = 0; i < count; i++)
+			{
+				copies.push_back(component->duplicate(board));
+			}
+		}
+		copies.clear();
+		arena_bytes = arena.reserved();
+	}
+	const auto arena_time = per_instance(start);
+
+	start = Clock::now();
+	for (std::size_t i = 0; i < count; i++)
+	{
+		auto instance = GateImage::create(*component, board)->instantiate();
+	}
+	const auto image_time = per_instance(start);
+
+	const auto image = GateImage::create(*component, board);
+	start = Clock::now();
+	for (std::size_t i = 0; i < count; i++)
+	{
+		auto instance = image->instantiate();
+	}
+	const auto instance_time = per_instance(start);
+
+	log("Instantiating `", name, "` ", count, " times");
+	log("  Gate tree copy:     ", duplicate_time, " us");
+	log("  Kept copies:        ", kept_time, " us");
+	log("  Kept in an arena:   ", arena_time, " us (", arena_bytes / count, " bytes each)");
+	log("  Image + instance:   ", image_time, " us");
+	log("  Instance of image:  ", instance_time, " us");
+}
+
+void activity_report(RawParser& parser)
+{
+	auto board = Board::instance();
+	const auto token = parser.advance_token();
+
+	MATCH(token.lexeme)
+		error("Expected 'on' or 'off'.");
+	CASE("on")
+		board->set_report_activity(true);
+		log("Activity report enabled.");
+	CASE("off")
+		board->set_report_activity(false);
+		log("Activity report disabled.");
+	ENDMATCH;
+}
+
+/**
+ * Run every accelerator against the HDL definition of its chip on random
+ * inputs, reporting the vectors on which they disagree.
+ */
+void verify_accelerators(std::size_t vectors)
+{
+	auto board = Board::instance();
+	const auto& builtins = BuiltinRegistry::instance();
+
+	std::mt19937_64 random{ 0x5eed };
+	std::size_t failures{};
+
+	for (const auto& builtin : builtins.get_builtins())
+	{
+		if (!builtin.accelerator) continue;
+
+		auto component = board->get_component(builtin.name);
+		if (component == nullptr)
+		{
+			log("  ", builtin.name, ": not loaded, skipped.");
+			continue;
+		}
+
+		// The reference is the chip as written in HDL.
+		auto reference = board->reference_copy(*component);
+
+		auto native = builtin.create();
+		if (reference->input_pins.size() != native->input_pins.size() 
+		    || reference->output_pins.size() != native->output_pins.size())
+		{
+			error("  " + builtin.name + ": the pins of the accelerator do not match the chip.");
+			failures++;
+			continue;
+		}
+
+		CompiledCircuit circuit(*reference);
+		std::vector<std::uint8_t> inputs(native->input_pins.size());
+		std::size_t mismatches{};
+
+		for (std::size_t vector = 0; vector < vectors; vector++)
+		{
+			for (std::size_t i = 0; i < inputs.size(); i++)
+			{
+				inputs[i] = static_cast<std::uint8_t>(random() & 1);
+				reference->input_pins[i].state = inputs[i] ? PinState::ACTIVE : PinState::INACTIVE;
+			}
+
+			circuit.step();
+			const auto row = builtin.evaluate(*native, inputs);
+
+			const auto count = reference->output_pins.size();
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const bool expected = (row >> (count - 1 - i)) & 1;
+				if (expected != (reference->output_pins[i].state == PinState::ACTIVE))
+				{
+					mismatches++;
+					break;
+				}
+			}
+		}
+
+		log("  ", builtin.name, ": ", mismatches, " mismatches in ", vectors, " vectors.");
+		failures += mismatches;
+	}
+
+	log(failures == 0 ? "Accelerators match their chips." : "Accelerators do not match their chips!");
+}
+
+/**
+ * Run the whole test suite in every compiled mode with and without
+ * accelerators, reporting the files whose results differ. The reference
+ * engine is left out: it runs chips as written whatever the setting.
+ */
+void verify_accelerated_tests()
+{
+	const auto files = test_files();
+	std::size_t differences{};
+
+	for (const auto& [mode, name] : { std::pair{ SimulationMode::Compiled, "compiled" }, 
+	                                  std::pair{ SimulationMode::Differential, "differential" },
+	                                  std::pair{ SimulationMode::Batched, "batched" } })
+	{
+		Board settings{ false };
+		settings.inherit_settings(*Board::instance());
+		settings.set_simulation_mode(mode);
+
+		settings.set_accelerated_builtins(false);
+		const auto as_written = run_test_files(files, settings);
+		settings.set_accelerated_builtins(true);
+		const auto accelerated = run_test_files(files, settings);
+
+		std::size_t mode_differences{};
+		for (std::size_t i = 0; i < files.size(); i++)
+		{
+			const auto& before = as_written[i];
+			const auto& after = accelerated[i];
+			if (before.passed == after.passed && before.failed == after.failed 
+			    && before.output.str() == after.output.str())
+			{
+				continue;
+			}
+
+			error("  " + std::string(name) + " " + files[i].filename().string() + ": " 
+			      + std::to_string(before.passed) + "/" + std::to_string(before.failed) + " passed/failed as written, " 
+			      + std::to_string(after.passed) + "/" + std::to_string(after.failed) + " accelerated.");
+			mode_differences++;
+		}
+
+		log("  ", name, ": ", mode_differences, " of ", files.size(), " test files differ.");
+		differences += mode_differences;
+	}
+
+	log(differences == 0 ? "Tests agree with and without accelerators." : "Tests do not agree with and without accelerators!");
+}
+
+void accelerate(RawParser& parser)
+{
+	auto board = Board::instance();
+	const auto token = parser.advance_token();
+
+	MATCH(token.lexeme)
+		error("Expected 'on', 'off' or 'verify'.");
+	CASE("on")
+		board->set_accelerated_builtins(true);
+		log("Accelerated builtins enabled for the compiled engines, the reference engine runs chips as written.");
+	CASE("off")
+		board->set_accelerated_builtins(false);
+		log("Accelerated builtins disabled.");
+	CASE("verify")
+		std::size_t vectors{ 10000 };
+		if (const auto number = parser.advance_token(); number.type == RawTokenType::Number)
+		{
+			vectors = std::max<std::size_t>(std::stoul(std::string(number.lexeme)), 1);
+		}
+		verify_accelerators(vectors);
+		verify_accelerated_tests();
+	ENDMATCH;
+}
+
+void simulation_mode(RawParser& parser)
+{
+	auto board = Board::instance();
+	const auto token = parser.advance_token();
+
+	MATCH(token.lexeme)
+		error("Unknown simulation mode '" + std::string(token.lexeme) + "', expected 'reference', 'compiled', 'differential' or 'batched'.");
+	CASE("reference")
+		board->set_simulation_mode(SimulationMode::Reference);
+		log("Simulation mode set to 'reference'.");
+	CASE("compiled")
+		board->set_simulation_mode(SimulationMode::Compiled);
+		log("Simulation mode set to 'compiled'.");
+	CASE("differential")
+		board->set_simulation_mode(SimulationMode::Differential);
+		log("Simulation mode set to 'differential'.");
+	CASE("batched")
+		board->set_simulation_mode(SimulationMode::Batched);
+		log("Simulation mode set to 'batched'.");
+	ENDMATCH;
+}
+
 void handle_input(RawParser& parser, std::string_view str)
 {
 	parser.set_source(std::string(str));
@@ -300,9 +851,16 @@ void handle_input(RawParser& parser, std::string_view str)
 		desc("info              ", "Display general information.");
 		desc("test        <chip>", "Run test file.");
 		desc("load        <chip>", "Load the specified chip.");
-		desc("compile     <file>", "Compile the hdl file with the given name.");
+		desc("compile     <file>", "Compile the hdl file with the given name, 'all' compiles every out of date one ('all force' every one).");
+		desc("serialize   <chip>", "Precompute the truth table of the chip, optionally followed by a max input count.");
+		desc("mode        <mode>", "Set the simulation mode (reference, compiled, differential, batched).");
+		desc("netlist     <chip>", "Show the compiled netlist and memory usage of the chip.");
+		desc("activity  <on|off>", "Report events processed per EVAL after each test.");
+		desc("bench       <chip>", "Time instantiating the chip, optionally followed by a repeat count.");
+		desc("accelerate  <mode>", "Use native 16-bit chips in the compiled engines (on, off, verify against HDL).");
 	CASE("info")
 		log("Gate Recipe Directory: ", GATE_RECIPE_DIRECTORY);
+		index_info();
 	CASE("test")
 		run_test(parser);
 #ifdef GUI_ENABLED
@@ -317,6 +875,16 @@ void handle_input(RawParser& parser, std::string_view str)
 		show_list(parser);
 	CASE("load")
 		load(parser);
+	CASE("mode")
+		simulation_mode(parser);
+	CASE("netlist")
+		netlist_info(parser);
+	CASE("accelerate")
+		accelerate(parser);
+	CASE("activity")
+		activity_report(parser);
+	CASE("bench")
+		bench(parser);
   ENDMATCH;
 }
 
@@ -333,15 +901,35 @@ void init()
 	auto _ = std::ofstream { init_file  };
 	run_file( init_file  );
 
-	// Load sketches.
-	using recursive_directory_iterator = std::filesystem::recursive_directory_iterator;
+	// Register sketches.
+	const auto board = Board::instance();
+	const auto manifest = BuildManifest::load();
+	std::vector<std::string> changed{};
 
 	for (const auto& gate : std::filesystem::directory_iterator(gate_sketch_dir))
   {
-		if (gate.path().extension() == GATE_EXTENSION)
+		if (gate.path().extension() != GATE_EXTENSION)
 		{
-			run_file(gate.path());
+			continue;
 		}
+
+		const auto name = gate.path().stem().string();
+		if (manifest.is_source_changed(name))
+		{
+			changed.push_back(name);
+		}
+
+		// Chips are only loaded once something asks for them.
+		board->register_file(name, gate.path().string());
+	}
+
+	if (!changed.empty())
+	{
+		std::sort(changed.begin(), changed.end());
+
+		std::string names{};
+		for (const auto& name : changed) names += (names.empty() ? "" : ", ") + name;
+		info("HDL changed since the last compilation: " + names + ". Run 'compile all' to update.");
 	}
 }
 
@@ -0,0 +1,129 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A read-only memory mapping of a whole file, unmapped on destruction.
+ */
+class MappedFile
+{
+public:
+  /**
+   * Map the file at the given path, returns nullptr if it does not exist or can't be mapped.
+   */
+  static auto open(const std::string& path) -> std::shared_ptr<const MappedFile>
+  {
+    auto file = std::shared_ptr<MappedFile>(new MappedFile());
+
+#ifdef _WIN32
+    file->handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file->handle == INVALID_HANDLE_VALUE) return nullptr;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file->handle, &size) || size.QuadPart == 0) return nullptr;
+    file->length = static_cast<std::size_t>(size.QuadPart);
+
+    file->mapping = CreateFileMappingA(file->handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (file->mapping == nullptr) return nullptr;
+
+    file->bytes = MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (file->bytes == nullptr) return nullptr;
+#else
+    const auto descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) return nullptr;
+
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+    {
+      ::close(descriptor);
+      return nullptr;
+    }
+    file->length = static_cast<std::size_t>(status.st_size);
+
+    auto* bytes = mmap(nullptr, file->length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    ::close(descriptor);
+    if (bytes == MAP_FAILED) return nullptr;
+    file->bytes = bytes;
+#endif
+
+    return file;
+  }
+
+  ~MappedFile()
+  {
+#ifdef _WIN32
+    if (bytes != nullptr) UnmapViewOfFile(bytes);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (handle != INVALID_HANDLE_VALUE) CloseHandle(handle);
+#else
+    if (bytes != nullptr) munmap(const_cast<void*>(bytes), length);
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  auto data() const -> const std::byte*
+  {
+    return static_cast<const std::byte*>(bytes);
+  }
+
+  auto size() const -> std::size_t
+  {
+    return length;
+  }
+
+private:
+  MappedFile() = default;
+
+private:
+  const void* bytes{ nullptr };
+  std::size_t length{ 0 };
+#ifdef _WIN32
+  HANDLE      handle{ INVALID_HANDLE_VALUE };
+  HANDLE      mapping{ nullptr };
+#endif
+};
+
+#endif /* MAPPED_FILE_H */
@@ -0,0 +1,81 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef NET_STORE_H
+#define NET_STORE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The values of every net of a compiled circuit, one byte per net, stored
+ * contiguously. Every top level instance owns its own NetStore, while the
+ * topology (instructions and fanout) lives in the shared Netlist.
+ */
+class NetStore
+{
+public:
+  explicit NetStore(std::size_t net_count = 0)
+    : values(net_count, 0)
+  {
+  }
+
+  auto get(std::uint32_t net) const -> std::uint8_t
+  {
+    return values[net];
+  }
+
+  /**
+   * Set the value of a net, returns true if the value changed.
+   */
+  auto set(std::uint32_t net, std::uint8_t value) -> bool
+  {
+    const bool changed = values[net] != value;
+    values[net] = value;
+    return changed;
+  }
+
+  auto reset() -> void
+  {
+    std::fill(values.begin(), values.end(), 0);
+  }
+
+  auto size() const -> std::size_t
+  {
+    return values.size();
+  }
+
+  auto memory_usage() const -> std::size_t
+  {
+    return sizeof(*this) + values.capacity();
+  }
+
+private:
+  std::vector<std::uint8_t> values;
+};
+
+#endif /* NET_STORE_H */
@@ -0,0 +1,1042 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+#include "netlist.hpp"
+#include "wire.hpp"
+
+namespace
+{
+
+constexpr std::uint32_t UNRESOLVED{ std::numeric_limits<std::uint32_t>::max() };
+constexpr std::uint32_t RESOLVING{ UNRESOLVED - 1 };
+
+/**
+ * Operations with more distinct non-constant inputs than this are not
+ * checked for constant or pass-through outputs.
+ */
+constexpr std::size_t FOLD_INPUT_LIMIT{ 10 };
+
+constexpr std::uint8_t UNKNOWN{ 2 };
+
+/**
+ * An operation before it has been levelized.
+ */
+struct PendingOp
+{
+  OpCode                          code;
+  bool                            stateful{};
+  std::vector<std::uint32_t>      inputs{};
+  std::vector<std::uint32_t>      outputs{};
+  Gate*                           gate{ nullptr };
+  const TruthTable*               table{ nullptr };
+};
+
+/**
+ * Flattens a gate hierarchy into pins, drivers and leaf operations.
+ */
+class NetlistCompiler
+{
+public:
+  explicit NetlistCompiler(Gate& top, bool optimized)
+    : top{ &top }
+    , optimized{ optimized }
+  {
+  }
+
+  auto compile() -> std::shared_ptr<const Netlist>
+  {
+    collect(*top, true);
+    collect_drivers();
+    resolve_nets();
+    build_ops();
+
+    report.operations = ops.size();
+    report.nets = net_count;
+
+    if (optimized)
+    {
+      optimize();
+    }
+
+    return levelize();
+  }
+
+private:
+  /**
+   * A custom gate is only treated as a lookup table once it has one. The top
+   * gate is always expanded when it can be, so that it can be (re)serialized.
+   */
+  auto is_leaf(const Gate& gate, bool is_top) const -> bool
+  {
+    if (gate.type != GateType::CUSTOM)
+    {
+      return true;
+    }
+
+    const auto has_table = gate.serialized 
+                        && gate.serialized_computation_ptr != nullptr
+                        && !gate.serialized_computation_ptr->empty();
+
+    return has_table && !(is_top && !gate.subgates.empty());
+  }
+
+  auto add_pin(const Pin& pin) -> std::uint32_t
+  {
+    const auto id = static_cast<std::uint32_t>(pins.size());
+    pin_ids[&pin] = id;
+    pins.push_back(&pin);
+    return id;
+  }
+
+  auto collect(Gate& gate, bool is_top) -> void
+  {
+    for (const auto& pin : gate.input_pins)
+    {
+      const auto id = add_pin(pin);
+      if (is_top) top_inputs.push_back(id);
+    }
+
+    for (const auto& pin : gate.output_pins)
+    {
+      const auto id = add_pin(pin);
+      if (is_top) top_outputs.push_back(id);
+    }
+
+    if (is_leaf(gate, is_top))
+    {
+      leaves.push_back(&gate);
+      return;
+    }
+
+    for (auto& subgate : gate.subgates)
+    {
+      collect(*subgate, false);
+    }
+  }
+
+  auto collect_drivers() -> void
+  {
+    drivers.resize(pins.size());
+    driven_by_op.resize(pins.size(), false);
+    pin_net.resize(pins.size(), UNRESOLVED);
+
+    for (std::uint32_t id = 0; id < pins.size(); id++)
+    {
+      for (const auto& connection : pins[id]->connections)
+      {
+        if (connection->output == nullptr) continue;
+
+        if (auto it = pin_ids.find(connection->output); it != pin_ids.end())
+        {
+          drivers[it->second].push_back(id);
+        }
+      }
+    }
+
+    for (const auto* leaf : leaves)
+    {
+      for (const auto& pin : leaf->output_pins)
+      {
+        driven_by_op[pin_ids.at(&pin)] = true;
+      }
+    }
+
+    for (const auto id : top_inputs)
+    {
+      is_top_input.insert(id);
+    }
+  }
+
+  /**
+   * A pin which is driven by exactly one wire simply shares the net of its driver.
+   * Everything else owns a net, extra drivers are turned into COPY operations.
+   */
+  auto resolve(std::uint32_t id) -> std::uint32_t
+  {
+    if (pin_net[id] == RESOLVING)
+    {
+      // A loop made only out of wires, break it with a fresh net.
+      pin_net[id] = net_count++;
+      return pin_net[id];
+    }
+
+    if (pin_net[id] != UNRESOLVED)
+    {
+      return pin_net[id];
+    }
+
+    const auto& pin_drivers = drivers[id];
+    const bool owns_net = driven_by_op[id] 
+                       || is_top_input.contains(id) 
+                       || pin_drivers.size() != 1;
+
+    if (owns_net)
+    {
+      pin_net[id] = net_count++;
+      for (const auto driver : pin_drivers)
+      {
+        copies.push_back({ driver, id });
+      }
+      return pin_net[id];
+    }
+
+    pin_net[id] = RESOLVING;
+    const auto net = resolve(pin_drivers.front());
+
+    // The loop might have already been broken at this pin.
+    if (pin_net[id] == RESOLVING)
+    {
+      pin_net[id] = net;
+    }
+
+    return pin_net[id];
+  }
+
+  auto resolve_nets() -> void
+  {
+    for (std::uint32_t id = 0; id < pins.size(); id++)
+    {
+      resolve(id);
+    }
+  }
+
+  auto nets_of(const ArenaVector<Pin>& gate_pins) -> std::vector<std::uint32_t>
+  {
+    std::vector<std::uint32_t> nets;
+    nets.reserve(gate_pins.size());
+    for (const auto& pin : gate_pins)
+    {
+      nets.push_back(pin_net[pin_ids.at(&pin)]);
+    }
+    return nets;
+  }
+
+  auto build_ops() -> void
+  {
+    for (auto* leaf : leaves)
+    {
+      PendingOp op{ .code = OpCode::BUILTIN };
+
+      switch (leaf->type)
+      {
+        break; case GateType::NAND: op.code = OpCode::NAND;
+        break; case GateType::DFF: op.code = OpCode::DFF;
+        break; case GateType::CUSTOM: 
+        {
+          op.code = OpCode::TABLE;
+          op.table = leaf->serialized_computation_ptr;
+        }
+        break; default: op.gate = leaf;
+      }
+
+      op.stateful = is_stateful(*leaf);
+      op.inputs = nets_of(leaf->input_pins);
+      op.outputs = nets_of(leaf->output_pins);
+      ops.push_back(std::move(op));
+    }
+
+    for (const auto& [src, dest] : copies)
+    {
+      ops.push_back({ .code = OpCode::COPY, .inputs = { pin_net[src] }, .outputs = { pin_net[dest] } });
+    }
+  }
+
+  /**
+   * Stateful gates are where feedback loops get cut, builtins say whether
+   * they hold any state when they are registered.
+   */
+  static auto is_stateful(const Gate& gate) -> bool
+  {
+    switch (gate.type)
+    {
+      case GateType::NAND:
+      case GateType::CUSTOM:
+        return false;
+      case GateType::DFF:
+        return true;
+      default:
+        return BuiltinRegistry::instance().get(gate.opcode).stateful;
+    }
+  }
+
+  /**
+   * The order in which combinational operations can be evaluated. Stateful
+   * operations and operations caught in a combinational loop are left out.
+   */
+  auto evaluation_order() const -> std::vector<std::uint32_t>
+  {
+    std::vector<std::vector<std::uint32_t>> writers(net_count);
+    for (std::uint32_t i = 0; i < ops.size(); i++)
+    {
+      if (ops[i].stateful) continue;
+      for (const auto net : ops[i].outputs)
+      {
+        writers[net].push_back(i);
+      }
+    }
+
+    std::vector<std::vector<std::uint32_t>> dependents(ops.size());
+    std::vector<std::uint32_t> pending(ops.size(), 0);
+    for (std::uint32_t i = 0; i < ops.size(); i++)
+    {
+      for (const auto net : ops[i].inputs)
+      {
+        for (const auto writer : writers[net])
+        {
+          dependents[writer].push_back(i);
+          pending[i]++;
+        }
+      }
+    }
+
+    std::vector<std::uint32_t> order;
+    for (std::uint32_t i = 0; i < ops.size(); i++)
+    {
+      if (pending[i] == 0) order.push_back(i);
+    }
+
+    for (std::size_t head = 0; head < order.size(); head++)
+    {
+      for (const auto dependent : dependents[order[head]])
+      {
+        if (--pending[dependent] == 0) order.push_back(dependent);
+      }
+    }
+
+    std::erase_if(order, [&](auto op) { return ops[op].stateful; });
+    return order;
+  }
+
+  auto find(std::uint32_t net) -> std::uint32_t
+  {
+    while (alias[net] != net)
+    {
+      alias[net] = alias[alias[net]];
+      net = alias[net];
+    }
+    return net;
+  }
+
+  /**
+   * Evaluate a combinational operation, the outputs are packed MSB first like truth table rows.
+   */
+  static auto evaluate(const PendingOp& op, std::uint64_t index) -> std::uint64_t
+  {
+    switch (op.code)
+    {
+      case OpCode::NAND: return (index & 0b11) != 0b11;
+      case OpCode::COPY: return index & 1;
+      case OpCode::TABLE: return op.table->get(index);
+      default: return 0;
+    }
+  }
+
+  /**
+   * Enumerate the inputs of an operation which are not constant to find out
+   * whether each output is constant or simply one of the inputs.
+   *
+   * Outputs are marked constant, or aliased to the input they forward.
+   * Even if the operation stays, its readers can skip it.
+   * Returns true if the operation is no longer needed, which is the case
+   * when every output is either forwarded or constantly 0.
+   * A net that nothing drives stays 0.
+   */
+  auto fold(const PendingOp& op) -> bool
+  {
+    std::vector<std::uint32_t> free{};
+    std::vector<int>           slot(op.inputs.size(), -1);
+    std::uint64_t              fixed{ 0 };
+
+    for (std::size_t i = 0; i < op.inputs.size(); i++)
+    {
+      const auto net = op.inputs[i];
+      const auto bit = op.inputs.size() - 1 - i;
+
+      if (constant[net] != UNKNOWN)
+      {
+        fixed |= static_cast<std::uint64_t>(constant[net]) << bit;
+        continue;
+      }
+
+      const auto it = std::find(free.begin(), free.end(), net);
+      slot[i] = static_cast<int>(it - free.begin());
+      if (it == free.end()) free.push_back(net);
+    }
+
+    if (free.size() > FOLD_INPUT_LIMIT)
+    {
+      return false;
+    }
+
+    const auto output_count = op.outputs.size();
+    std::vector<std::uint8_t>  value(output_count, UNKNOWN);
+    std::vector<bool>          is_constant(output_count, true);
+    std::vector<std::uint32_t> forwards(output_count, (1u << free.size()) - 1);
+
+    for (std::uint32_t row = 0; row < (1u << free.size()); row++)
+    {
+      auto index = fixed;
+      for (std::size_t i = 0; i < op.inputs.size(); i++)
+      {
+        if (slot[i] >= 0) index |= static_cast<std::uint64_t>((row >> slot[i]) & 1) << (op.inputs.size() - 1 - i);
+      }
+
+      const auto result = evaluate(op, index);
+      for (std::size_t k = 0; k < output_count; k++)
+      {
+        const auto bit = static_cast<std::uint8_t>((result >> (output_count - 1 - k)) & 1);
+        if (value[k] == UNKNOWN) value[k] = bit;
+        if (value[k] != bit) is_constant[k] = false;
+
+        for (std::size_t j = 0; j < free.size(); j++)
+        {
+          if (((row >> j) & 1) != bit) forwards[k] &= ~(1u << j);
+        }
+      }
+    }
+
+    bool removable = true;
+    bool forwarded = true;
+    for (std::size_t k = 0; k < output_count; k++)
+    {
+      const auto net = op.outputs[k];
+      if (is_constant[k])
+      {
+        constant[net] = value[k];
+        removable = removable && value[k] == 0;
+        forwarded = false;
+      }
+      else if (forwards[k] != 0)
+      {
+        alias[net] = free[std::countr_zero(forwards[k])];
+      }
+      else
+      {
+        removable = false;
+      }
+    }
+
+    if (removable)
+    {
+      (forwarded ? report.aliased : report.folded)++;
+    }
+
+    return removable;
+  }
+
+  /**
+   * Simplify the flattened operations, in evaluation order: substitute forwarded
+   * nets, fold constants, merge identical operations and finally drop whatever
+   * does not contribute to an output.
+   */
+  auto optimize() -> void
+  {
+    alias.resize(net_count);
+    std::iota(alias.begin(), alias.end(), 0);
+
+    std::vector<std::uint32_t> writer_count(net_count, 0);
+    for (const auto& op : ops)
+    {
+      for (const auto net : op.outputs) writer_count[net]++;
+    }
+
+    std::vector<bool> is_input(net_count, false);
+    for (const auto id : top_inputs)
+    {
+      is_input[pin_net[id]] = true;
+    }
+
+    // Nothing drives these, so they are never anything but 0.
+    constant.assign(net_count, UNKNOWN);
+    for (std::uint32_t net = 0; net < net_count; net++)
+    {
+      if (writer_count[net] == 0 && !is_input[net]) constant[net] = 0;
+    }
+
+    // Only operations which are the sole writer of their outputs can be replaced.
+    const auto replaceable = [&](const PendingOp& op)
+    {
+      return op.code != OpCode::BUILTIN && std::all_of(op.outputs.begin(), op.outputs.end(), [&](auto net)
+      {
+        return writer_count[net] == 1 && !is_input[net];
+      });
+    };
+
+    std::vector<bool> removed(ops.size(), false);
+    std::map<std::tuple<OpCode, const TruthTable*, std::vector<std::uint32_t>>, std::uint32_t> seen{};
+
+    for (const auto index : evaluation_order())
+    {
+      auto& op = ops[index];
+      for (auto& net : op.inputs) net = find(net);
+
+      if (!replaceable(op)) continue;
+
+      if (fold(op))
+      {
+        removed[index] = true;
+        continue;
+      }
+
+      auto inputs = op.inputs;
+      if (op.code == OpCode::NAND) std::sort(inputs.begin(), inputs.end());
+
+      const auto [it, inserted] = seen.try_emplace({ op.code, op.table, std::move(inputs) }, index);
+      if (inserted) continue;
+
+      const auto& original = ops[it->second];
+      for (std::size_t k = 0; k < op.outputs.size(); k++)
+      {
+        alias[op.outputs[k]] = original.outputs[k];
+      }
+
+      removed[index] = true;
+      report.merged++;
+    }
+
+    for (auto& op : ops)
+    {
+      for (auto& net : op.inputs) net = find(net);
+    }
+
+    for (const auto id : top_outputs)
+    {
+      pin_net[id] = find(pin_net[id]);
+    }
+
+    remove_dead(removed);
+    compact_nets();
+  }
+
+  /**
+   * Walk back from the outputs of the chip and drop every operation that was
+   * not reached, along with those which were already replaced.
+   */
+  auto remove_dead(const std::vector<bool>& removed) -> void
+  {
+    std::vector<std::vector<std::uint32_t>> writers(net_count);
+    for (std::uint32_t i = 0; i < ops.size(); i++)
+    {
+      if (removed[i]) continue;
+      for (const auto net : ops[i].outputs) writers[net].push_back(i);
+    }
+
+    std::vector<bool> live_net(net_count, false);
+    std::vector<bool> live(ops.size(), false);
+    std::vector<std::uint32_t> work{};
+
+    for (const auto id : top_outputs)
+    {
+      if (!live_net[pin_net[id]])
+      {
+        live_net[pin_net[id]] = true;
+        work.push_back(pin_net[id]);
+      }
+    }
+
+    while (!work.empty())
+    {
+      const auto net = work.back();
+      work.pop_back();
+
+      for (const auto writer : writers[net])
+      {
+        if (live[writer]) continue;
+        live[writer] = true;
+
+        for (const auto input : ops[writer].inputs)
+        {
+          if (live_net[input]) continue;
+          live_net[input] = true;
+          work.push_back(input);
+        }
+      }
+    }
+
+    std::vector<PendingOp> kept{};
+    kept.reserve(ops.size());
+    for (std::uint32_t i = 0; i < ops.size(); i++)
+    {
+      if (live[i]) kept.push_back(std::move(ops[i]));
+      else if (!removed[i]) report.removed++;
+    }
+
+    ops = std::move(kept);
+  }
+
+  /**
+   * Renumber the nets which are still in use.
+   */
+  auto compact_nets() -> void
+  {
+    std::vector<std::uint32_t> renumbered(net_count, UNRESOLVED);
+    std::uint32_t count{ 0 };
+
+    const auto renumber = [&](std::uint32_t& net)
+    {
+      if (renumbered[net] == UNRESOLVED) renumbered[net] = count++;
+      net = renumbered[net];
+    };
+
+    for (const auto id : top_inputs) renumber(pin_net[id]);
+    for (const auto id : top_outputs) renumber(pin_net[id]);
+
+    for (auto& op : ops)
+    {
+      for (auto& net : op.inputs) renumber(net);
+      for (auto& net : op.outputs) renumber(net);
+    }
+
+    net_count = count;
+  }
+
+  /**
+   * Build the CSR fanout table. Readers are added in instruction order and an
+   * instruction reading the same net twice is only listed once.
+   */
+  static auto build_fanout(Netlist& netlist) -> void
+  {
+    constexpr auto NONE = std::numeric_limits<std::uint32_t>::max();
+
+    const auto for_each_read = [&](auto&& f)
+    {
+      std::vector<std::uint32_t> last_reader(netlist.net_count, NONE);
+      for (std::uint32_t i = 0; i < netlist.instructions.size(); i++)
+      {
+        const auto& instruction = netlist.instructions[i];
+        for (std::uint32_t k = 0; k < instruction.input_count; k++)
+        {
+          const auto net = netlist.operands[instruction.inputs + k];
+          if (last_reader[net] == i) continue;
+          last_reader[net] = i;
+          f(net, i);
+        }
+      }
+    };
+
+    netlist.fanout_offsets.assign(netlist.net_count + 1, 0);
+    for_each_read([&](auto net, auto) { netlist.fanout_offsets[net + 1]++; });
+
+    for (std::size_t net = 0; net < netlist.net_count; net++)
+    {
+      netlist.fanout_offsets[net + 1] += netlist.fanout_offsets[net];
+    }
+
+    netlist.fanout.resize(netlist.fanout_offsets.back());
+    std::vector<std::uint32_t> cursor(netlist.fanout_offsets.begin(), netlist.fanout_offsets.end() - 1);
+    for_each_read([&](auto net, auto instruction) { netlist.fanout[cursor[net]++] = instruction; });
+  }
+
+  /**
+   * Sort the operations by level. An operation sits one level above the deepest
+   * combinational operation which writes any of its inputs. Operations which are
+   * part of a purely combinational loop are placed after everything else.
+   */
+  auto levelize() -> std::shared_ptr<const Netlist>
+  {
+    const auto op_count = ops.size();
+
+    // Which combinational operations write each net.
+    std::vector<std::vector<std::uint32_t>> writers(net_count);
+    for (std::uint32_t i = 0; i < op_count; i++)
+    {
+      if (ops[i].stateful) continue;
+      for (const auto net : ops[i].outputs)
+      {
+        writers[net].push_back(i);
+      }
+    }
+
+    // Dependency graph (Kahn's algorithm).
+    std::vector<std::vector<std::uint32_t>> dependents(op_count);
+    std::vector<std::uint32_t> pending(op_count, 0);
+    for (std::uint32_t i = 0; i < op_count; i++)
+    {
+      for (const auto net : ops[i].inputs)
+      {
+        for (const auto writer : writers[net])
+        {
+          dependents[writer].push_back(i);
+          pending[i]++;
+        }
+      }
+    }
+
+    std::vector<std::uint32_t> levels(op_count, 0);
+    std::vector<std::uint32_t> queue;
+    std::vector<bool>          placed(op_count, false);
+    queue.reserve(op_count);
+
+    for (std::uint32_t i = 0; i < op_count; i++)
+    {
+      if (pending[i] == 0) queue.push_back(i);
+    }
+
+    for (std::size_t head = 0; head < queue.size(); head++)
+    {
+      const auto op = queue[head];
+      placed[op] = true;
+      for (const auto dependent : dependents[op])
+      {
+        levels[dependent] = std::max(levels[dependent], levels[op] + 1);
+        if (--pending[dependent] == 0)
+        {
+          queue.push_back(dependent);
+        }
+      }
+    }
+
+    std::uint32_t max_level = 0;
+    for (const auto op : queue)
+    {
+      max_level = std::max(max_level, levels[op]);
+    }
+
+    for (std::uint32_t i = 0; i < op_count; i++)
+    {
+      if (!placed[i])
+      {
+        levels[i] = max_level + 1;
+        queue.push_back(i);
+      }
+    }
+
+    std::stable_sort(queue.begin(), queue.end(), [&](auto a, auto b) { return levels[a] < levels[b]; });
+
+    // Emit the instructions.
+    auto netlist = std::make_shared<Netlist>();
+    netlist->net_count = net_count;
+    netlist->optimization = report;
+    netlist->instructions.reserve(op_count);
+
+    for (const auto index : queue)
+    {
+      const auto& op = ops[index];
+      Instruction instruction{
+        .code = op.code,
+        .stateful = op.stateful,
+        .input_count = static_cast<std::uint16_t>(op.inputs.size()),
+        .output_count = static_cast<std::uint16_t>(op.outputs.size()),
+        .level = levels[index],
+        .table = op.table,
+      };
+
+      if (op.gate != nullptr)
+      {
+        instruction.builtin = static_cast<std::uint32_t>(netlist->builtins.size());
+        netlist->builtins.push_back(op.gate);
+      }
+
+      instruction.inputs = static_cast<std::uint32_t>(netlist->operands.size());
+      netlist->operands.insert(netlist->operands.end(), op.inputs.begin(), op.inputs.end());
+
+      instruction.outputs = static_cast<std::uint32_t>(netlist->operands.size());
+      netlist->operands.insert(netlist->operands.end(), op.outputs.begin(), op.outputs.end());
+
+      netlist->level_count = std::max(netlist->level_count, levels[index] + 1);
+      netlist->instructions.push_back(instruction);
+    }
+
+    build_fanout(*netlist);
+
+    // An instruction is a feedback instruction if something at or before it reads its outputs.
+    for (std::uint32_t i = 0; i < netlist->instructions.size(); i++)
+    {
+      auto& instruction = netlist->instructions[i];
+      for (std::uint32_t k = 0; k < instruction.output_count; k++)
+      {
+        const auto readers = netlist->readers(netlist->operands[instruction.outputs + k]);
+        if (!readers.empty() && readers.front() <= i)
+        {
+          instruction.feedback = true;
+        }
+      }
+    }
+
+    for (const auto id : top_inputs)
+    {
+      netlist->input_nets.push_back(pin_net[id]);
+    }
+
+    for (const auto id : top_outputs)
+    {
+      netlist->output_nets.push_back(pin_net[id]);
+    }
+
+    return netlist;
+  }
+
+private:
+  Gate*                                         top;
+  std::unordered_map<const Pin*, std::uint32_t> pin_ids{};
+  std::vector<const Pin*>                       pins{};
+  std::vector<std::uint32_t>                    top_inputs{};
+  std::vector<std::uint32_t>                    top_outputs{};
+  std::unordered_set<std::uint32_t>             is_top_input{};
+  std::vector<Gate*>                            leaves{};
+  std::vector<std::vector<std::uint32_t>>       drivers{};
+  std::vector<bool>                             driven_by_op{};
+  std::vector<std::uint32_t>                    pin_net{};
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> copies{};
+  std::vector<PendingOp>                        ops{};
+  std::uint32_t                                 net_count{};
+  bool                                          optimized{};
+  std::vector<std::uint32_t>                    alias{};
+  std::vector<std::uint8_t>                     constant{};
+  OptimizationReport                            report{};
+};
+
+} /* namespace */
+
+auto Netlist::compile(Gate& gate, bool optimize) -> std::shared_ptr<const Netlist>
+{
+  return NetlistCompiler(gate, optimize).compile();
+}
+
+auto Netlist::is_combinational() const -> bool
+{
+  return std::none_of(instructions.begin(), instructions.end(), [](const auto& instruction)
+  {
+    return instruction.stateful || instruction.feedback || instruction.code == OpCode::DFF;
+  });
+}
+
+CompiledCircuit::CompiledCircuit(Gate& gate)
+  : CompiledCircuit(gate, Netlist::compile(gate))
+{
+}
+
+CompiledCircuit::CompiledCircuit(Gate& gate, std::shared_ptr<const Netlist> netlist)
+  : CompiledCircuit(gate, std::move(netlist), {})
+{
+}
+
+CompiledCircuit::CompiledCircuit(Gate& gate, std::shared_ptr<const Netlist> netlist, std::vector<std::unique_ptr<Gate>> own_builtins)
+  : gate{ &gate }
+  , netlist{ std::move(netlist) }
+  , builtins{ this->netlist->builtins }
+  , owned_builtins{ std::move(own_builtins) }
+  , nets{ this->netlist->net_count }
+  , buckets(this->netlist->level_count)
+  , queued(this->netlist->instructions.size(), 0)
+{
+  // Without builtins of its own the circuit drives the ones inside of the compiled gate.
+  for (std::size_t i = 0; i < owned_builtins.size(); i++)
+  {
+    builtins[i] = owned_builtins[i].get();
+  }
+
+  for (const auto* builtin : builtins)
+  {
+    evaluators.push_back(BuiltinRegistry::instance().get(builtin->opcode).evaluate);
+  }
+
+  const auto& instructions = this->netlist->instructions;
+  for (std::uint32_t i = 0; i < instructions.size(); i++)
+  {
+    if (instructions[i].stateful) stateful.push_back(i);
+
+    // Nothing has been evaluated yet, so everything starts out scheduled.
+    schedule(i);
+  }
+}
+
+auto CompiledCircuit::memory_usage() const -> std::size_t
+{
+  std::size_t bytes = sizeof(*this) + nets.memory_usage() + queued.capacity() + stateful.capacity() * sizeof(std::uint32_t);
+
+  bytes += builtins.capacity() * sizeof(Gate*) + evaluators.capacity() * sizeof(BuiltinEvaluator);
+  for (const auto& bucket : buckets)
+  {
+    bytes += sizeof(bucket) + bucket.capacity() * sizeof(std::uint32_t);
+  }
+
+  for (const auto& builtin : owned_builtins)
+  {
+    bytes += builtin->memory_usage();
+  }
+
+  return bytes;
+}
+
+void CompiledCircuit::schedule(std::uint32_t instruction)
+{
+  if (queued[instruction]) return;
+  queued[instruction] = 1;
+
+  const auto level = netlist->instructions[instruction].level;
+  buckets[level].push_back(instruction);
+  lowest_level = std::min(lowest_level, level);
+}
+
+void CompiledCircuit::drive(std::uint32_t net, std::uint8_t value)
+{
+  if (!nets.set(net, value)) return;
+
+  activity.events++;
+  for (const auto reader : netlist->readers(net))
+  {
+    schedule(reader);
+  }
+}
+
+void CompiledCircuit::load_inputs()
+{
+  const auto& input_nets = netlist->input_nets;
+  for (std::size_t i = 0; i < input_nets.size(); i++)
+  {
+    drive(input_nets[i], gate->input_pins[i].is_active() ? 1 : 0);
+  }
+}
+
+void CompiledCircuit::store_outputs()
+{
+  const auto& output_nets = netlist->output_nets;
+  for (std::size_t i = 0; i < output_nets.size(); i++)
+  {
+    gate->output_pins[i].state = (nets.get(output_nets[i]) != 0) ? PinState::ACTIVE : PinState::INACTIVE;
+  }
+}
+
+void CompiledCircuit::execute(const Instruction& instruction)
+{
+  const auto* in = &netlist->operands[instruction.inputs];
+  const auto* out = &netlist->operands[instruction.outputs];
+
+  switch (instruction.code)
+  {
+    case OpCode::NAND:
+    {
+      drive(out[0], !(nets.get(in[0]) && nets.get(in[1])));
+      break;
+    }
+    case OpCode::DFF:
+    {
+      if (nets.get(in[1])) drive(out[0], nets.get(in[0]));
+      break;
+    }
+    case OpCode::COPY:
+    {
+      drive(out[0], nets.get(in[0]));
+      break;
+    }
+    case OpCode::TABLE:
+    {
+      std::size_t index{ 0 };
+      for (std::uint32_t i = 0; i < instruction.input_count; i++)
+      {
+        index = (index << 1) | nets.get(in[i]);
+      }
+
+      const auto row = instruction.table->get(index);
+      const auto count = instruction.output_count;
+      for (std::uint32_t i = 0; i < count; i++)
+      {
+        drive(out[i], (row >> (count - 1 - i)) & 1);
+      }
+      break;
+    }
+    case OpCode::BUILTIN:
+    {
+      // Builtins read straight from the nets, their pins are not used.
+      std::array<std::uint8_t, BUILTIN_INPUT_LIMIT> inputs;
+      for (std::uint32_t i = 0; i < instruction.input_count; i++)
+      {
+        inputs[i] = nets.get(in[i]);
+      }
+
+      const auto row = evaluators[instruction.builtin](*builtins[instruction.builtin], { inputs.data(), instruction.input_count });
+      const auto count = instruction.output_count;
+      for (std::uint32_t i = 0; i < count; i++)
+      {
+        drive(out[i], (row >> (count - 1 - i)) & 1);
+      }
+      break;
+    }
+  }
+}
+
+void CompiledCircuit::step()
+{
+  const auto& instructions = netlist->instructions;
+  const auto  level_count = netlist->level_count;
+
+  load_inputs();
+  for (const auto instruction : stateful)
+  {
+    schedule(instruction);
+  }
+
+  // A combinational loop may never settle, bound the work done per step.
+  const auto budget = activity.evaluations + SETTLE_PASS_LIMIT * instructions.size();
+  bool settled = true;
+
+  while (lowest_level < level_count)
+  {
+    const auto level = lowest_level;
+    auto& bucket = buckets[level];
+
+    // Instructions of the same level may be appended while draining (feedback),
+    // an oscillating loop keeps growing the bucket so the budget is checked here.
+    std::size_t k = 0;
+    for (; k < bucket.size(); k++)
+    {
+      if (activity.evaluations >= budget)
+      {
+        settled = false;
+        break;
+      }
+
+      const auto instruction = bucket[k];
+      queued[instruction] = 0;
+      activity.evaluations++;
+      execute(instructions[instruction]);
+    }
+
+    if (!settled)
+    {
+      // Whatever is left stays scheduled, the loop carries on at the next step.
+      bucket.erase(bucket.begin(), bucket.begin() + static_cast<std::ptrdiff_t>(k));
+      activity.unsettled++;
+      break;
+    }
+    bucket.clear();
+
+    // Unless feedback scheduled something at a lower level, move on.
+    if (lowest_level == level) lowest_level++;
+  }
+
+  activity.steps++;
+  store_outputs();
+}
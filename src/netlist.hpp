@@ -0,0 +1,287 @@
+/**
+ * MIT License
+ *
+ * Copyright (c) 2023 Ochawin A.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#pragma once
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "gate.hpp"
+#include "net_store.hpp"
+
+/**
+ * How a top level chip is simulated.
+ *
+ * - Reference:    The original recursive pin/wire propagation (Gate::simulate).
+ * - Compiled:     The chip is flattened into a levelized Netlist and stepped linearly.
+ * - Differential: Both engines are run side by side and their outputs are compared.
+ * - Batched:      Compiled, and the EVALs of purely combinational chips are evaluated
+ *                 64 at a time by a ParallelCircuit.
+ *
+ * Reference is the default. A clocked part acts once per clock-high period, the
+ * first time it is evaluated. When another clocked part changes its inputs
+ * within the same EVAL, what it sees depends on the order of evaluation, which
+ * differs between the engines (the reference engine also counts forwards as
+ * delays, the compiled one collapses them). Designs and tests must not depend
+ * on it, computer_differential.tst runs the programs of computer.tst in both.
+ */
+enum class SimulationMode
+{
+  Reference,
+  Compiled,
+  Differential,
+  Batched
+};
+
+/**
+ * Operations of the flattened netlist.
+ */
+enum class OpCode : std::uint8_t
+{
+  NAND,
+  DFF,
+  COPY,
+  TABLE,
+  BUILTIN
+};
+
+/**
+ * A single flattened operation. The nets it reads and writes are stored
+ * contiguously in Netlist::operands, starting at 'inputs' and 'outputs'.
+ * BUILTIN operations refer to their builtin gate by index ('builtin').
+ */
+struct Instruction
+{
+  OpCode                          code;
+  bool                            feedback{};
+  bool                            stateful{};
+  std::uint16_t                   input_count{};
+  std::uint16_t                   output_count{};
+  std::uint32_t                   level{};
+  std::uint32_t                   inputs{};
+  std::uint32_t                   outputs{};
+  std::uint32_t                   builtin{};
+  const TruthTable*               table{ nullptr };
+};
+
+/**
+ * What the optimization pass of Netlist::compile did.
+ *
+ * - operations, nets: Size of the flattened netlist before it was optimized.
+ * - aliased:          Pass-throughs (forwards, copies) replaced by the net they forward.
+ * - folded:           Operations whose outputs turned out constant.
+ * - merged:           Operations identical to an earlier one (same operation, same inputs).
+ * - removed:          Operations whose outputs reach no output of the chip.
+ */
+struct OptimizationReport
+{
+  std::size_t operations{};
+  std::size_t nets{};
+  std::size_t aliased{};
+  std::size_t folded{};
+  std::size_t merged{};
+  std::size_t removed{};
+};
+
+/**
+ * A Netlist is a gate hierarchy flattened into a topologically sorted list of
+ * instructions over integer net indices. Wires do not exist anymore, a wire
+ * simply makes both of its pins refer to the same net.
+ *
+ * Stateful operations (DFF and stateful builtins) break cycles, everything that
+ * reads them is levelized as if their outputs were primary inputs.
+ */
+struct Netlist
+{
+  /**
+   * Flatten the given gate. The builtin gates inside of it are kept as
+   * prototypes (Netlist::builtins), so the gate must outlive the netlist.
+   *
+   * Unless 'optimize' is false the flattened netlist is simplified before it
+   * is levelized: pass-throughs are collapsed, constants are propagated,
+   * duplicate operations are merged and dead logic is removed. Only the
+   * outputs of the chip are preserved, internal nets may disappear.
+   */
+  [[nodiscard]] static auto compile(Gate& gate, bool optimize = true) -> std::shared_ptr<const Netlist>;
+
+  /**
+   * The instructions which read the given net, in execution order.
+   */
+  auto readers(std::uint32_t net) const -> std::span<const std::uint32_t>
+  {
+    return { fanout.data() + fanout_offsets[net], fanout.data() + fanout_offsets[net + 1] };
+  }
+
+  /**
+   * True if no instruction holds state or sits in a feedback loop, meaning
+   * the outputs only depend on the current inputs.
+   */
+  auto is_combinational() const -> bool;
+
+  auto memory_usage() const -> std::size_t
+  {
+    return sizeof(*this)
+         + instructions.capacity() * sizeof(Instruction)
+         + (operands.capacity() + input_nets.capacity() + output_nets.capacity()) * sizeof(std::uint32_t)
+         + (fanout_offsets.capacity() + fanout.capacity()) * sizeof(std::uint32_t)
+         + builtins.capacity() * sizeof(Gate*);
+  }
+
+  std::vector<Instruction>   instructions{};
+  std::vector<std::uint32_t> operands{};
+  std::vector<std::uint32_t> input_nets{};
+  std::vector<std::uint32_t> output_nets{};
+  std::size_t                net_count{};
+  std::uint32_t              level_count{};
+
+  /**
+   * Fanout of every net in CSR form, the readers of net 'n' are stored
+   * in fanout[fanout_offsets[n]] up to fanout[fanout_offsets[n + 1]].
+   */
+  std::vector<std::uint32_t> fanout_offsets{};
+  std::vector<std::uint32_t> fanout{};
+
+  /**
+   * The builtin gates of the compiled gate, indexed by Instruction::builtin.
+   * They hold state, so every independent instance needs its own copies.
+   */
+  std::vector<Gate*>         builtins{};
+
+  OptimizationReport         optimization{};
+};
+
+/**
+ * Simulation counters of a compiled circuit.
+ *
+ * - steps:       Number of times the circuit was stepped (one per EVAL).
+ * - evaluations: Instructions executed.
+ * - events:      Net value changes, each of which schedules the readers of the net.
+ * - unsettled:   Steps which ran out of their budget (SETTLE_PASS_LIMIT) before every
+ *                feedback loop settled, their outputs are whatever the loops were at.
+ */
+struct Activity
+{
+  std::size_t steps{};
+  std::size_t evaluations{};
+  std::size_t events{};
+  std::size_t unsettled{};
+
+  auto operator+=(const Activity& other) -> Activity&
+  {
+    steps += other.steps;
+    evaluations += other.evaluations;
+    events += other.events;
+    unsettled += other.unsettled;
+    return *this;
+  }
+};
+
+/**
+ * A compiled, simulatable view of a gate. Inputs are read from the gate's input
+ * pins and the results are written back into its output pins on every step,
+ * the internal pins of the gate are left untouched.
+ *
+ * Simulation is event driven: only the readers of nets which changed value are
+ * scheduled, into one work queue per level, and the queues are drained in
+ * level order. Stateful instructions are scheduled on every step. A step gives up
+ * once it evaluated SETTLE_PASS_LIMIT times the instruction count, which only a
+ * combinational loop that never settles (an oscillator) reaches.
+ */
+class CompiledCircuit
+{
+public:
+  explicit CompiledCircuit(Gate& gate);
+
+  /**
+   * Simulate the gate with a netlist which was already compiled from it.
+   */
+  CompiledCircuit(Gate& gate, std::shared_ptr<const Netlist> netlist);
+
+  /**
+   * Simulate a shared netlist with builtin gates of its own, one per
+   * Netlist::builtins entry. Only the pins of 'gate' are used.
+   */
+  CompiledCircuit(Gate& gate, std::shared_ptr<const Netlist> netlist, std::vector<std::unique_ptr<Gate>> builtins);
+
+  /**
+   * Simulate one tick.
+   */
+  void step();
+
+  auto get_activity() const -> const Activity&
+  {
+    return activity;
+  }
+
+  auto get_netlist() const -> const Netlist&
+  {
+    return *netlist;
+  }
+
+  auto get_nets() const -> const NetStore&
+  {
+    return nets;
+  }
+
+  /**
+   * Bytes of state held by this circuit (the netlist is shared and not included).
+   */
+  auto memory_usage() const -> std::size_t;
+
+private:
+  /**
+   * Execute a single instruction, driving its outputs.
+   */
+  void execute(const Instruction& instruction);
+
+  /**
+   * Set the value of a net and schedule its readers if it changed.
+   */
+  void drive(std::uint32_t net, std::uint8_t value);
+
+  void schedule(std::uint32_t instruction);
+
+  void load_inputs();
+
+  void store_outputs();
+
+private:
+  Gate*                                   gate;
+  std::shared_ptr<const Netlist>          netlist;
+  std::vector<Gate*>                      builtins;
+  std::vector<std::unique_ptr<Gate>>      owned_builtins;
+  std::vector<BuiltinEvaluator>           evaluators{};
+  NetStore                                nets;
+  std::vector<std::vector<std::uint32_t>> buckets;
+  std::vector<std::uint8_t>               queued;
+  std::vector<std::uint32_t>              stateful;
+  std::uint32_t                           lowest_level{};
+  Activity                                activity{};
+};
+
+#endif /* NETLIST_H */
@@ -0,0 +1,418 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <algorithm>
+
+#include "parallel_circuit.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PARALLEL_CIRCUIT_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+/**
+ * Tables with more inputs than this are always looked up lane by lane.
+ */
+constexpr std::size_t SLICE_INPUT_LIMIT{ 12 };
+
+void mux_scalar(ParallelCircuit::Lanes* o, const ParallelCircuit::Lanes* sel,
+                const ParallelCircuit::Lanes* hi, const ParallelCircuit::Lanes* lo, std::size_t words)
+{
+  for (std::size_t w = 0; w < words; w++) o[w] = lo[w] ^ (sel[w] & (lo[w] ^ hi[w]));
+}
+
+#ifdef PARALLEL_CIRCUIT_X86
+
+__attribute__((target("avx2")))
+void mux_avx2(ParallelCircuit::Lanes* o, const ParallelCircuit::Lanes* sel,
+              const ParallelCircuit::Lanes* hi, const ParallelCircuit::Lanes* lo, std::size_t words)
+{
+  for (std::size_t w = 0; w < words; w += 4)
+  {
+    const auto s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sel + w));
+    const auto h = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hi + w));
+    const auto l = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lo + w));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + w), _mm256_xor_si256(l, _mm256_and_si256(s, _mm256_xor_si256(l, h))));
+  }
+}
+
+__attribute__((target("avx512f")))
+void mux_avx512(ParallelCircuit::Lanes* o, const ParallelCircuit::Lanes* sel,
+                const ParallelCircuit::Lanes* hi, const ParallelCircuit::Lanes* lo, std::size_t words)
+{
+  for (std::size_t w = 0; w < words; w += 8)
+  {
+    // 0xCA is the truth table of s ? h : l.
+    const auto s = _mm512_loadu_si512(sel + w);
+    const auto h = _mm512_loadu_si512(hi + w);
+    const auto l = _mm512_loadu_si512(lo + w);
+    _mm512_storeu_si512(o + w, _mm512_ternarylogic_epi64(s, h, l, 0xCA));
+  }
+}
+
+#endif /* PARALLEL_CIRCUIT_X86 */
+
+} /* namespace */
+
+ParallelCircuit::ParallelCircuit(std::shared_ptr<const Netlist> netlist, std::size_t words)
+  : netlist{ std::move(netlist) }
+  , words{ words }
+  , kernel{ LaneKernel::Scalar }
+  , nets(this->netlist->net_count * words, 0)
+{
+  const auto best = best_kernel();
+
+  if (best == LaneKernel::AVX512 && words % 8 == 0)
+  {
+    kernel = LaneKernel::AVX512;
+  }
+  else if (best != LaneKernel::Scalar && words % 4 == 0)
+  {
+    kernel = LaneKernel::AVX2;
+  }
+
+  for (const auto& instruction : this->netlist->instructions)
+  {
+    if (instruction.code == OpCode::TABLE)
+    {
+      sliced_tables.push_back(slice_table(instruction));
+    }
+  }
+}
+
+auto ParallelCircuit::supports(const Netlist& netlist) -> bool
+{
+  const auto no_builtins = std::none_of(netlist.instructions.begin(), netlist.instructions.end(), [](const auto& instruction)
+  {
+    return instruction.code == OpCode::BUILTIN;
+  });
+
+  return no_builtins && netlist.is_combinational();
+}
+
+auto ParallelCircuit::best_kernel() -> LaneKernel
+{
+#ifdef PARALLEL_CIRCUIT_X86
+  static const auto kernel = []
+  {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return LaneKernel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return LaneKernel::AVX2;
+    return LaneKernel::Scalar;
+  }();
+  return kernel;
+#else
+  return LaneKernel::Scalar;
+#endif
+}
+
+auto ParallelCircuit::kernel_name(LaneKernel kernel) -> std::string_view
+{
+  switch (kernel)
+  {
+    break; case LaneKernel::Scalar: return "scalar";
+    break; case LaneKernel::AVX2:   return "avx2";
+    break; case LaneKernel::AVX512: return "avx512";
+  }
+  return "unknown";
+}
+
+auto ParallelCircuit::slice_table(const Instruction& instruction) -> SlicedTable
+{
+  const std::size_t inputs = instruction.input_count;
+  const std::size_t count = instruction.output_count;
+
+  if (inputs > SLICE_INPUT_LIMIT) return {};
+
+  // A lookup costs a few steps per lane and pin, a mux a few per word.
+  const std::size_t budget{ WORD_LANES * (inputs + count) };
+  const std::size_t rows{ std::size_t{ 1 } << inputs };
+
+  SlicedTable sliced{};
+  std::vector<std::uint8_t> column(rows);
+  std::size_t muxes{ 0 };
+
+  // Rows first .. first + (rows >> input) all share the inputs before 'input'.
+  const auto build = [&](auto& self, std::size_t first, std::uint32_t input) -> bool
+  {
+    const auto last = first + (rows >> input);
+    const auto value = column[first];
+
+    if (std::all_of(column.begin() + first, column.begin() + last, [value](auto bit) { return bit == value; }))
+    {
+      sliced.program.push_back(value ? SlicedTable::ONES : SlicedTable::ZERO);
+      return true;
+    }
+
+    if (++muxes > budget) return false;
+
+    const auto half = (last - first) / 2;
+    if (!self(self, first, input + 1) || !self(self, first + half, input + 1)) return false;
+
+    sliced.program.push_back(SlicedTable::MUX + input);
+    return true;
+  };
+
+  for (std::size_t output = 0; output < count; output++)
+  {
+    for (std::size_t row = 0; row < rows; row++)
+    {
+      column[row] = (instruction.table->get(row) >> (count - 1 - output)) & 1;
+    }
+
+    sliced.output_offsets.push_back(static_cast<std::uint32_t>(sliced.program.size()));
+    if (!build(build, 0, 0)) return {};
+  }
+
+  sliced.output_offsets.push_back(static_cast<std::uint32_t>(sliced.program.size()));
+  return sliced;
+}
+
+void ParallelCircuit::execute_table(const Instruction& instruction, const SlicedTable& sliced, MuxKernel mux)
+{
+  if (sliced.program.empty())
+  {
+    lookup_table(instruction);
+    return;
+  }
+
+  const auto* in = &netlist->operands[instruction.inputs];
+  const auto* out = &netlist->operands[instruction.outputs];
+
+  // A tree over n inputs never holds more than n + 1 values at once.
+  auto& stack = table_lanes;
+  stack.resize((instruction.input_count + 1) * words);
+
+  for (std::size_t output = 0; output < instruction.output_count; output++)
+  {
+    std::size_t top{ 0 };
+
+    for (auto i = sliced.output_offsets[output]; i < sliced.output_offsets[output + 1]; i++)
+    {
+      const auto code = sliced.program[i];
+      switch (code)
+      {
+        break; case SlicedTable::ZERO: std::fill_n(stack.begin() + top++ * words, words, Lanes{ 0 });
+        break; case SlicedTable::ONES: std::fill_n(stack.begin() + top++ * words, words, ~Lanes{ 0 });
+        break; default:
+        {
+          top -= 2;
+          auto* lo = stack.data() + top++ * words;
+          mux(lo, nets.data() + in[code - SlicedTable::MUX] * words, lo + words, lo, words);
+        }
+      }
+    }
+
+    std::copy_n(stack.begin(), words, nets.begin() + out[output] * words);
+  }
+}
+
+void ParallelCircuit::lookup_table(const Instruction& instruction)
+{
+  const auto* in = &netlist->operands[instruction.inputs];
+  const auto* out = &netlist->operands[instruction.outputs];
+  const auto  count = instruction.output_count;
+
+  auto& results = table_lanes;
+
+  // Every lane indexes the table on its own.
+  for (std::size_t word = 0; word < words; word++)
+  {
+    results.assign(count, 0);
+
+    for (std::size_t lane = 0; lane < WORD_LANES; lane++)
+    {
+      std::size_t index{ 0 };
+      for (std::uint32_t i = 0; i < instruction.input_count; i++)
+      {
+        index = (index << 1) | ((nets[in[i] * words + word] >> lane) & 1);
+      }
+
+      const auto row = instruction.table->get(index);
+      for (std::uint32_t i = 0; i < count; i++)
+      {
+        results[i] |= static_cast<Lanes>((row >> (count - 1 - i)) & 1) << lane;
+      }
+    }
+
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+      nets[out[i] * words + word] = results[i];
+    }
+  }
+}
+
+void ParallelCircuit::evaluate()
+{
+  switch (kernel)
+  {
+    break; case LaneKernel::Scalar: evaluate_scalar();
+    break; case LaneKernel::AVX2:   evaluate_avx2();
+    break; case LaneKernel::AVX512: evaluate_avx512();
+  }
+}
+
+void ParallelCircuit::evaluate_scalar()
+{
+  const auto& operands = netlist->operands;
+  auto* lanes = nets.data();
+
+  auto sliced = sliced_tables.begin();
+  for (const auto& instruction : netlist->instructions)
+  {
+    const auto* in = &operands[instruction.inputs];
+    const auto* out = &operands[instruction.outputs];
+
+    switch (instruction.code)
+    {
+      break; case OpCode::NAND:
+      {
+        const auto* a = lanes + in[0] * words;
+        const auto* b = lanes + in[1] * words;
+        auto*       o = lanes + out[0] * words;
+        for (std::size_t w = 0; w < words; w++) o[w] = ~(a[w] & b[w]);
+      }
+      break; case OpCode::COPY:
+      {
+        std::copy_n(lanes + in[0] * words, words, lanes + out[0] * words);
+      }
+      break; case OpCode::TABLE:
+      {
+        execute_table(instruction, *sliced++, mux_scalar);
+      }
+      break; default:; // Not supported, see ParallelCircuit::supports.
+    }
+  }
+}
+
+#ifdef PARALLEL_CIRCUIT_X86
+
+__attribute__((target("avx2")))
+void ParallelCircuit::evaluate_avx2()
+{
+  const auto& operands = netlist->operands;
+  auto* lanes = nets.data();
+  const auto ones = _mm256_set1_epi64x(-1);
+
+  auto sliced = sliced_tables.begin();
+  for (const auto& instruction : netlist->instructions)
+  {
+    const auto* in = &operands[instruction.inputs];
+    const auto* out = &operands[instruction.outputs];
+
+    switch (instruction.code)
+    {
+      break; case OpCode::NAND:
+      {
+        const auto* a = lanes + in[0] * words;
+        const auto* b = lanes + in[1] * words;
+        auto*       o = lanes + out[0] * words;
+        for (std::size_t w = 0; w < words; w += 4)
+        {
+          const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+          const auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + w), _mm256_xor_si256(_mm256_and_si256(x, y), ones));
+        }
+      }
+      break; case OpCode::COPY:
+      {
+        const auto* a = lanes + in[0] * words;
+        auto*       o = lanes + out[0] * words;
+        for (std::size_t w = 0; w < words; w += 4)
+        {
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + w), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w)));
+        }
+      }
+      break; case OpCode::TABLE:
+      {
+        execute_table(instruction, *sliced++, mux_avx2);
+      }
+      break; default:; // Not supported, see ParallelCircuit::supports.
+    }
+  }
+}
+
+__attribute__((target("avx512f")))
+void ParallelCircuit::evaluate_avx512()
+{
+  const auto& operands = netlist->operands;
+  auto* lanes = nets.data();
+
+  auto sliced = sliced_tables.begin();
+  for (const auto& instruction : netlist->instructions)
+  {
+    const auto* in = &operands[instruction.inputs];
+    const auto* out = &operands[instruction.outputs];
+
+    switch (instruction.code)
+    {
+      break; case OpCode::NAND:
+      {
+        const auto* a = lanes + in[0] * words;
+        const auto* b = lanes + in[1] * words;
+        auto*       o = lanes + out[0] * words;
+        for (std::size_t w = 0; w < words; w += 8)
+        {
+          const auto x = _mm512_loadu_si512(a + w);
+          const auto y = _mm512_loadu_si512(b + w);
+
+          // 0x3F is the truth table of ~(x & y).
+          _mm512_storeu_si512(o + w, _mm512_ternarylogic_epi64(x, y, y, 0x3F));
+        }
+      }
+      break; case OpCode::COPY:
+      {
+        const auto* a = lanes + in[0] * words;
+        auto*       o = lanes + out[0] * words;
+        for (std::size_t w = 0; w < words; w += 8)
+        {
+          _mm512_storeu_si512(o + w, _mm512_loadu_si512(a + w));
+        }
+      }
+      break; case OpCode::TABLE:
+      {
+        execute_table(instruction, *sliced++, mux_avx512);
+      }
+      break; default:; // Not supported, see ParallelCircuit::supports.
+    }
+  }
+}
+
+#else
+
+void ParallelCircuit::evaluate_avx2()
+{
+  evaluate_scalar();
+}
+
+void ParallelCircuit::evaluate_avx512()
+{
+  evaluate_scalar();
+}
+
+#endif /* PARALLEL_CIRCUIT_X86 */
@@ -0,0 +1,186 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef PARALLEL_CIRCUIT_H
+#define PARALLEL_CIRCUIT_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "netlist.hpp"
+
+/**
+ * The instruction sets a ParallelCircuit can be evaluated with, picked at runtime.
+ */
+enum class LaneKernel : std::uint8_t
+{
+  Scalar,
+  AVX2,
+  AVX512
+};
+
+/**
+ * Bit-parallel simulation of a compiled netlist. Every net holds a block of
+ * 64-bit words with one independent lane per bit, so a NAND becomes ~(a & b)
+ * and a single sweep over the instructions evaluates 64 input vectors per word.
+ *
+ * Blocks of 4 or 8 words (256 or 512 lanes) are evaluated with AVX2 or AVX-512
+ * when the CPU supports them, otherwise word by word.
+ *
+ * Small TABLEs are bit-sliced: every output is a tree of muxes over the input
+ * lanes (see SlicedTable), which runs on the same kernels. Tables for which
+ * the tree would cost more than looking up every lane are looked up lane by lane.
+ *
+ * Lanes do not share any state, so only netlists made of NAND, COPY and TABLE
+ * instructions without feedback are supported (see ParallelCircuit::supports).
+ */
+class ParallelCircuit
+{
+public:
+  using Lanes = std::uint64_t;
+
+  static constexpr std::size_t WORD_LANES{ 64 };
+
+  /**
+   * Simulate 'words' * 64 lanes per net.
+   */
+  explicit ParallelCircuit(std::shared_ptr<const Netlist> netlist, std::size_t words = 1);
+
+  /**
+   * Whether every lane of the netlist can be evaluated independently, which
+   * means it is purely combinational.
+   */
+  static auto supports(const Netlist& netlist) -> bool;
+
+  /**
+   * The widest kernel the CPU supports.
+   */
+  static auto best_kernel() -> LaneKernel;
+
+  static auto kernel_name(LaneKernel kernel) -> std::string_view;
+
+  /**
+   * Words per net which make full use of the widest kernel.
+   */
+  static auto preferred_words() -> std::size_t
+  {
+    return best_kernel() == LaneKernel::AVX512 ? 8 : 4;
+  }
+
+  /**
+   * The lanes of a top level input when the input vectors are the consecutive
+   * integers base .. base + 63 (base being a multiple of 64), and 'bit' is the
+   * bit of the vector which drives the input.
+   */
+  static constexpr auto counting_lanes(std::size_t bit, std::uint64_t base) -> Lanes
+  {
+    constexpr Lanes patterns[] = {
+      0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+      0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL,
+    };
+
+    if (bit < std::size(patterns)) return patterns[bit];
+    return ((base >> bit) & 1) ? ~Lanes{ 0 } : Lanes{ 0 };
+  }
+
+  auto set_input(std::size_t input, std::size_t word, Lanes lanes) -> void
+  {
+    nets[netlist->input_nets[input] * words + word] = lanes;
+  }
+
+  auto get_output(std::size_t output, std::size_t word) const -> Lanes
+  {
+    return nets[netlist->output_nets[output] * words + word];
+  }
+
+  auto lane_count() const -> std::size_t
+  {
+    return words * WORD_LANES;
+  }
+
+  auto get_kernel() const -> LaneKernel
+  {
+    return kernel;
+  }
+
+  /**
+   * Evaluate every lane.
+   */
+  void evaluate();
+
+private:
+  /**
+   * The outputs of a TABLE as mux trees, in postfix order. A tree splits the
+   * rows on the first input, so its leaves are runs of rows with the same value.
+   *
+   * - ZERO, ONES: Push a constant.
+   * - MUX + i:    Pop 'hi' and 'lo', push 'in[i] ? hi : lo'.
+   *
+   * Empty if the table is looked up lane by lane.
+   */
+  struct SlicedTable
+  {
+    static constexpr std::uint32_t ZERO{ 0 };
+    static constexpr std::uint32_t ONES{ 1 };
+    static constexpr std::uint32_t MUX{ 2 };
+
+    std::vector<std::uint32_t> program{};
+    std::vector<std::uint32_t> output_offsets{};
+  };
+
+  /**
+   * o = sel ? hi : lo for a block of words.
+   */
+  using MuxKernel = void (*)(Lanes* o, const Lanes* sel, const Lanes* hi, const Lanes* lo, std::size_t words);
+
+  static auto slice_table(const Instruction& instruction) -> SlicedTable;
+
+  void evaluate_scalar();
+
+  void evaluate_avx2();
+
+  void evaluate_avx512();
+
+  void execute_table(const Instruction& instruction, const SlicedTable& sliced, MuxKernel mux);
+
+  void lookup_table(const Instruction& instruction);
+
+private:
+  std::shared_ptr<const Netlist> netlist;
+  std::size_t                    words;
+  LaneKernel                     kernel;
+  std::vector<Lanes>             nets;
+  std::vector<Lanes>             table_lanes{};
+
+  /**
+   * One per TABLE instruction, in the order of the instructions.
+   */
+  std::vector<SlicedTable>       sliced_tables{};
+};
+
+#endif /* PARALLEL_CIRCUIT_H */
@@ -26,22 +26,29 @@
 #ifndef PIN_H
 #define PIN_H
 
+#include <cstdint>
 #include <vector>
-#include <memory>
 
-class Wire;
+#include "arena.hpp"
+
+struct Wire;
 class Gate;
 
-enum class PinState
+enum class PinState : std::uint8_t
 {
   INACTIVE,
   ACTIVE
 };
 
+/**
+ * A pin of the gate tree. It holds its own state and wires, the tree the
+ * reference engine runs on is not backed by a NetStore. Compiled circuits
+ * only address nets by index.
+ */
 struct Pin
 {
   PinState state;
-  std::vector<std::shared_ptr<Wire>> connections;
+  ArenaVector<Wire*> connections;
   Gate* parent;
 
   Pin(Gate* p = nullptr)
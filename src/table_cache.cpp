@@ -0,0 +1,143 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "common.hpp"
+#include "content_hash.hpp"
+#include "mapped_file.hpp"
+#include "table_cache.hpp"
+
+namespace
+{
+
+constexpr char TABLE_MAGIC[8] = { 'G', 'A', 'T', 'E', 'T', 'B', 'L', '1' };
+
+struct TableHeader
+{
+  char          magic[8];
+  std::uint64_t hash;
+  std::uint64_t width;
+  std::uint64_t rows;
+};
+
+} /* namespace */
+
+auto TableCache::directory() -> std::string
+{
+  return DEFAULT_GATE_DIRECTORY + SEPERATOR + TABLE_CACHE_DIRECTORY;
+}
+
+auto TableCache::path(std::string_view name, std::uint64_t hash) -> std::string
+{
+  return directory() + SEPERATOR + std::string(name) + "." + ContentHash::to_hex(hash) + TABLE_EXTENSION;
+}
+
+auto TableCache::load(Gate& gate, std::uint64_t hash) -> bool
+{
+  auto file = MappedFile::open(path(gate.name, hash));
+  if (file == nullptr || file->size() < sizeof(TableHeader))
+  {
+    return false;
+  }
+
+  TableHeader header{};
+  std::memcpy(&header, file->data(), sizeof(TableHeader));
+
+  const auto rows = std::uint64_t{ 1 } << gate.input_pins.size();
+  const auto words = TruthTable::word_count(header.width, header.rows);
+
+  const auto valid = std::memcmp(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC)) == 0
+                  && header.hash == hash
+                  && header.width == gate.output_pins.size()
+                  && header.rows == rows
+                  && file->size() == sizeof(TableHeader) + words * sizeof(std::uint64_t);
+
+  if (!valid)
+  {
+    return false;
+  }
+
+  // The header keeps the words 8 byte aligned within the (page aligned) mapping.
+  const auto* data = reinterpret_cast<const std::uint64_t*>(file->data() + sizeof(TableHeader));
+  gate.use_table(TruthTable(header.width, header.rows, data, std::move(file)));
+  return true;
+}
+
+auto TableCache::save(const Gate& gate, std::uint64_t hash) -> bool
+{
+  const auto& table = gate.serialized_computation;
+  if (!gate.serialized || table.empty())
+  {
+    return false;
+  }
+
+  std::error_code ec{};
+  std::filesystem::create_directories(directory(), ec);
+
+  // Tables of older versions of the gate are of no use anymore.
+  const auto prefix = gate.name + ".";
+  for (const auto& entry : std::filesystem::directory_iterator(directory(), ec))
+  {
+    const auto file_name = entry.path().filename().string();
+    if (file_name.starts_with(prefix) && entry.path().extension() == TABLE_EXTENSION)
+    {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+
+  const auto target = path(gate.name, hash);
+  // Boards loading in parallel may save the same table at once, each writes its own file.
+  const auto temporary = temporary_file(target);
+
+  {
+    std::ofstream file{ temporary, std::ios::binary | std::ios::trunc };
+    if (!file)
+    {
+      return false;
+    }
+
+    TableHeader header{};
+    std::memcpy(header.magic, TABLE_MAGIC, sizeof(TABLE_MAGIC));
+    header.hash = hash;
+    header.width = table.width();
+    header.rows = table.size();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(table.data()), table.memory_usage());
+
+    if (!file)
+    {
+      return false;
+    }
+  }
+
+  // Readers never see a partially written table.
+  std::filesystem::rename(temporary, target, ec);
+  return !ec;
+}
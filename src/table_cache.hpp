@@ -0,0 +1,61 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef TABLE_CACHE_H
+#define TABLE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "gate.hpp"
+
+/**
+ * Truth tables of precomputed gates, saved under gates/tables/ as
+ * '<name>.<content hash>.table' and memory mapped when they are loaded again.
+ *
+ * The content hash covers the gate and everything it depends on (see
+ * Board::content_hash), so editing any dependency simply misses the cache.
+ */
+class TableCache
+{
+public:
+  static auto directory() -> std::string;
+
+  static auto path(std::string_view name, std::uint64_t hash) -> std::string;
+
+  /**
+   * Give the gate its cached table, returns false if there is no valid one.
+   */
+  static auto load(Gate& gate, std::uint64_t hash) -> bool;
+
+  /**
+   * Save the table of a serialized gate, replacing older tables of the same gate.
+   */
+  static auto save(const Gate& gate, std::uint64_t hash) -> bool;
+};
+
+#endif /* TABLE_CACHE_H */
@@ -0,0 +1,171 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads executing queued tasks in order.
+ */
+class ThreadPool
+{
+public:
+  explicit ThreadPool(std::size_t thread_count = default_thread_count())
+  {
+    for (std::size_t i = 0; i < thread_count; i++)
+    {
+      workers.emplace_back([this] { work(); });
+    }
+  }
+
+  ~ThreadPool()
+  {
+    {
+      std::scoped_lock lock{ mutex };
+      stopping = true;
+    }
+    condition.notify_all();
+
+    for (auto& worker : workers)
+    {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  /**
+   * The pool shared by the whole program, created on first use.
+   */
+  static auto instance() -> ThreadPool&
+  {
+    static ThreadPool pool{};
+    return pool;
+  }
+
+  static auto default_thread_count() -> std::size_t
+  {
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  auto size() const -> std::size_t
+  {
+    return workers.size();
+  }
+
+  void submit(std::function<void()> task)
+  {
+    {
+      std::scoped_lock lock{ mutex };
+      tasks.push_back(std::move(task));
+    }
+    condition.notify_one();
+  }
+
+  /**
+   * Call f(0) .. f(count - 1) across the pool and wait for all of them.
+   *
+   * The calling thread takes part in the work and only waits for indices
+   * which are already being worked on, so this may be used from inside
+   * of a task without starving the pool.
+   */
+  template <typename F>
+  void parallel_for(std::size_t count, F&& f)
+  {
+    struct Progress
+    {
+      std::atomic<std::size_t> next{ 0 };
+      std::atomic<std::size_t> done{ 0 };
+      std::mutex               mutex{};
+      std::condition_variable  finished{};
+    };
+
+    auto progress = std::make_shared<Progress>();
+
+    // Helpers which start after everything was claimed return without touching 'f'.
+    const auto run = [progress, count, &f]
+    {
+      for (auto i = progress->next++; i < count; i = progress->next++)
+      {
+        f(i);
+        if (++progress->done == count)
+        {
+          std::scoped_lock lock{ progress->mutex };
+          progress->finished.notify_all();
+        }
+      }
+    };
+
+    const auto helpers = std::min(size(), count) - (count > 0 ? 1 : 0);
+    for (std::size_t i = 0; i < helpers; i++)
+    {
+      submit(run);
+    }
+
+    run();
+
+    std::unique_lock lock{ progress->mutex };
+    progress->finished.wait(lock, [&] { return progress->done == count; });
+  }
+
+private:
+  void work()
+  {
+    while (true)
+    {
+      std::function<void()> task;
+      {
+        std::unique_lock lock{ mutex };
+        condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+        if (stopping && tasks.empty()) return;
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+      }
+      task();
+    }
+  }
+
+private:
+  std::vector<std::thread>          workers{};
+  std::deque<std::function<void()>> tasks{};
+  std::mutex                        mutex{};
+  std::condition_variable           condition{};
+  bool                              stopping{ false };
+};
+
+#endif /* THREAD_POOL_H */
@@ -0,0 +1,152 @@
+/** 
+ * MIT License
+ * 
+ * Copyright (c) 2023 Ochawin A.
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#pragma once
+#ifndef TRUTH_TABLE_H
+#define TRUTH_TABLE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * The precomputed outputs of a gate for every input combination, packed to
+ * exactly 'width' bits per row (the number of output pins, at most 64).
+ *
+ * Rows are stored back to back in 64-bit words, so a block of 64 rows always
+ * starts on a word boundary. Writing disjoint ranges of such blocks from
+ * different threads is therefore safe.
+ *
+ * The words are either owned by the table or borrowed (read-only) from a
+ * buffer kept alive by 'owner', such as a memory mapped cache file.
+ */
+class TruthTable
+{
+public:
+  static constexpr std::size_t MAX_WIDTH{ 64 };
+  static constexpr std::size_t ALIGNED_ROWS{ 64 };
+
+  TruthTable() = default;
+
+  TruthTable(std::size_t width, std::size_t rows)
+    : row_width{ width }
+    , row_count{ rows }
+    , words(word_count(width, rows), 0)
+  {
+  }
+
+  TruthTable(std::size_t width, std::size_t rows, const std::uint64_t* borrowed, std::shared_ptr<const void> owner)
+    : row_width{ width }
+    , row_count{ rows }
+    , borrowed{ borrowed }
+    , owner{ std::move(owner) }
+  {
+  }
+
+  /**
+   * Number of 64-bit words holding a table of the given size.
+   */
+  static constexpr auto word_count(std::size_t width, std::size_t rows) -> std::size_t
+  {
+    return (width * rows + 63) / 64 + 1;
+  }
+
+  /**
+   * Extract a row, the first output pin is the most significant bit.
+   */
+  auto get(std::size_t row) const -> std::uint64_t
+  {
+    const auto bit = row * row_width;
+    const auto word = bit / 64;
+    const auto shift = bit % 64;
+    const auto* data = this->data();
+
+    auto value = data[word] >> shift;
+    if (shift + row_width > 64)
+    {
+      value |= data[word + 1] << (64 - shift);
+    }
+
+    return value & mask();
+  }
+
+  /**
+   * Only valid for tables which own their words.
+   */
+  auto set(std::size_t row, std::uint64_t value) -> void
+  {
+    const auto bit = row * row_width;
+    const auto word = bit / 64;
+    const auto shift = bit % 64;
+
+    value &= mask();
+    words[word] = (words[word] & ~(mask() << shift)) | (value << shift);
+    if (shift + row_width > 64)
+    {
+      const auto spill = 64 - shift;
+      words[word + 1] = (words[word + 1] & ~(mask() >> spill)) | (value >> spill);
+    }
+  }
+
+  auto size() const -> std::size_t
+  {
+    return row_count;
+  }
+
+  auto width() const -> std::size_t
+  {
+    return row_width;
+  }
+
+  auto empty() const -> bool
+  {
+    return row_count == 0;
+  }
+
+  auto memory_usage() const -> std::size_t
+  {
+    return word_count(row_width, row_count) * sizeof(std::uint64_t);
+  }
+
+  auto data() const -> const std::uint64_t*
+  {
+    return (borrowed != nullptr) ? borrowed : words.data();
+  }
+
+private:
+  auto mask() const -> std::uint64_t
+  {
+    return (row_width >= 64) ? ~std::uint64_t{ 0 } : ((std::uint64_t{ 1 } << row_width) - 1);
+  }
+
+private:
+  std::size_t                 row_width{ 0 };
+  std::size_t                 row_count{ 0 };
+  std::vector<std::uint64_t>  words{};
+  const std::uint64_t*        borrowed{ nullptr };
+  std::shared_ptr<const void> owner{};
+};
+
+#endif /* TRUTH_TABLE_H */
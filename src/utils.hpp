@@ -30,7 +30,10 @@
 #include <algorithm>
 #include <string_view>
 #include <cctype>
+#include <functional>
 #include <iostream>
+#include <string>
+#include <unordered_map>
 #include "pin.hpp"
 
 inline std::string make_lower(std::string_view str)
@@ -41,6 +44,23 @@ inline std::string make_lower(std::string_view str)
   return input;
 }
 
+/**
+ * Hash of string keyed maps, transparent so that lookups by string_view
+ * do not need to allocate a string.
+ */
+struct NameHash
+{
+  using is_transparent = void;
+
+  auto operator()(std::string_view name) const noexcept -> std::size_t
+  {
+    return std::hash<std::string_view>{}(name);
+  }
+};
+
+template <typename T>
+using NameIndex = std::unordered_map<std::string, T, NameHash, std::equal_to<>>;
+
 /**
  * Logging related functions.
  */
@@ -67,9 +87,9 @@ inline void error(std::string_view dump)
 	std::cout << "Error: " << dump << '\n';
 }
 
-template <typename ReturnType, typename DataType>
+template <typename ReturnType, typename DataType, typename Allocator, typename BitTest>
 inline std::enable_if_t<std::is_unsigned_v<ReturnType>, ReturnType> 
-bitvec_to_uint(const std::vector<DataType>& vec, const std::function<bool(const DataType&)> f, std::size_t start, std::size_t end)
+bitvec_to_uint(const std::vector<DataType, Allocator>& vec, BitTest&& f, std::size_t start, std::size_t end)
 {
 	ReturnType val {0};
 
@@ -84,15 +104,14 @@ bitvec_to_uint(const std::vector<DataType>& vec, const std::function<bool(const
 
 template <typename ReturnType = std::size_t>
 inline std::enable_if_t<std::is_unsigned_v<ReturnType>, ReturnType> 
-pinvec_to_uint(const std::vector<Pin>& vec, std::size_t start, std::size_t end)
+pinvec_to_uint(const ArenaVector<Pin>& vec, std::size_t start, std::size_t end)
 {
-	auto pin_is_active = [](const Pin& p) { return p.is_active(); };
-	return bitvec_to_uint<ReturnType, Pin>(vec, std::move(pin_is_active), start, end);
+	return bitvec_to_uint<ReturnType, Pin>(vec, [](const Pin& p) { return p.is_active(); }, start, end);
 }
 
-template <typename T, typename VT>
+template <typename T, typename VT, typename Allocator, typename BitSetter>
 inline std::enable_if_t<std::is_unsigned_v<T>> 
-set_bitvec(T value, std::vector<VT>& target, std::function<void(VT&, bool)> f, std::size_t start, std::size_t end)
+set_bitvec(T value, std::vector<VT, Allocator>& target, BitSetter&& f, std::size_t start, std::size_t end)
 {
 	T size = end - start;
   for (T offset = 0; offset < size; offset++)
@@ -104,10 +123,9 @@ set_bitvec(T value, std::vector<VT>& target, std::function<void(VT&, bool)> f, s
 
 template <typename T>
 inline std::enable_if_t<std::is_unsigned_v<T>> 
-set_pinvec(T value, std::vector<Pin>& target, std::size_t start, std::size_t end)
+set_pinvec(T value, ArenaVector<Pin>& target, std::size_t start, std::size_t end)
 {
-	const auto f = [](Pin& pin, bool on){ pin.state = on ? PinState::ACTIVE : PinState::INACTIVE; };
-	set_bitvec<T, Pin>(value, target, std::move(f), start, end);
+	set_bitvec<T, Pin>(value, target, [](Pin& pin, bool on){ pin.state = on ? PinState::ACTIVE : PinState::INACTIVE; }, start, end);
 }
 
 